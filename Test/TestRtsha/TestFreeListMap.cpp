@@ -3,6 +3,7 @@
 #include "FreeMap.h"
 #include "MemoryPage.h"
 #include "heap.h"
+#include <vector>
 
 using namespace internal;
 
@@ -30,4 +31,69 @@ TEST(TestFreeMap, TestCreateInsertDeleteFind)
 	rtsha_page* page = heap.select_page(rtsha_page_size_type::PageTypeBig, 1024);
 
 	heap.free(heap.malloc(2100));
-}
\ No newline at end of file
+}
+TEST(TestFreeMap, TestIntrusiveTree)
+{
+	const size_t count = 500U;
+	const size_t block_size = 2U * FREE_MAP_MIN_BLOCK_SIZE;
+	std::vector<size_t> memory((count * block_size) / sizeof(size_t));
+	std::vector<size_t> blocks(count);
+	std::vector<bool> inserted(count, false);
+
+	rtsha_page page;
+	FreeMap map(&page);
+
+	/*blocks with many equal sizes*/
+	for (size_t i = 0U; i < count; i++)
+	{
+		blocks[i] = reinterpret_cast<size_t>(memory.data()) + i * block_size;
+		MemoryBlock block(reinterpret_cast<rtsha_block*>(blocks[i]));
+		block.prepare();
+		block.setSize(FREE_MAP_MIN_BLOCK_SIZE + (i % 7U) * sizeof(size_t));
+		block.setFree();
+	}
+
+	for (size_t i = 0U; i < count; i++)
+	{
+		size_t k = MemoryBlock(reinterpret_cast<rtsha_block*>(blocks[i])).getSize();
+		map.insert(k, blocks[i]);
+		inserted[i] = true;
+	}
+	EXPECT_EQ(map.size(), count);
+
+	/*delete in random order and compare the best fit with a linear search*/
+	size_t left = count;
+	while (left > 0U)
+	{
+		size_t i = (size_t)std::rand() % count;
+		EXPECT_EQ(map.exists(blocks[i]), (bool)inserted[i]);
+		EXPECT_EQ(map.del(blocks[i]), (bool)inserted[i]);
+		if (inserted[i])
+		{
+			inserted[i] = false;
+			left--;
+		}
+		EXPECT_EQ(map.size(), left);
+
+		size_t request = FREE_MAP_MIN_BLOCK_SIZE + ((size_t)std::rand() % 8U) * sizeof(size_t);
+		size_t best = 0U;
+		for (size_t j = 0U; j < count; j++)
+		{
+			size_t s = MemoryBlock(reinterpret_cast<rtsha_block*>(blocks[j])).getSize();
+			if (inserted[j] && (s >= request) && ((best == 0U) || (s < MemoryBlock(reinterpret_cast<rtsha_block*>(best)).getSize())))
+			{
+				best = blocks[j];
+			}
+		}
+		size_t found = map.find(request);
+		if (best == 0U)
+		{
+			EXPECT_EQ(found, 0U);
+		}
+		else
+		{
+			EXPECT_NE(found, 0U);
+			EXPECT_EQ(MemoryBlock(reinterpret_cast<rtsha_block*>(found)).getSize(), MemoryBlock(reinterpret_cast<rtsha_block*>(best)).getSize());
+		}
+	}
+}
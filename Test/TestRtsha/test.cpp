@@ -8,12 +8,24 @@
 #include <string>
 #include "VisualizePage.h"
 #include "FastPlusAllocator.h"
-#include "InternMapAllocator.h"
 #include "errors.h"
 #include "BigMemoryPage.h"
 #include "PowerTwoMemoryPage.h"
+#include "ObjectPool.h"
+#include "MemoryResource.h"
+#include "NodeAllocator.h"
+#include "ForwardListAllocator.h"
+#include "TLSFMemoryPage.h"
+#include "MmapRegionProvider.h"
+#include "memory_kernels.h"
 #include "time.h"
 #include <unordered_map>
+#include <vector>
+#include <map>
+#include <set>
+#include <list>
+#include <forward_list>
+#include <thread>
 using namespace std;
 using namespace std::chrono;
 
@@ -201,6 +213,1067 @@ TEST(TestCaseClassHeap, TestHeapCreatePowerTwoPage)
 }
 
 
+TEST(TestCaseClassHeap, TestHeapPowerTwoBuddyMerge)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypePowerTwo, 8U * 65536U, 0U, 32U, 2048U));
+
+	rtsha_page* page = heap.select_page(rtsha_page_size_type::PageTypePowerTwo, 64, true);
+	EXPECT_TRUE(page != nullptr);
+	size_t initial_free_blocks = page->free_blocks;
+
+	/*a burst of small allocations splits all blocks of the page until the page is full*/
+	std::vector<void*> memory;
+	for (size_t i = 0U; i < 10000U; i++)
+	{
+		void* ptr = heap.malloc(20U + (size_t)std::rand() % 100U);
+		if (ptr == nullptr)
+		{
+			break;
+		}
+		memory.push_back(ptr);
+	}
+	EXPECT_GT(memory.size(), 1000U);
+	EXPECT_EQ(heap.malloc(65536U), nullptr);
+
+	/*release in random order, the buddies are merged up to the initial blocks*/
+	const size_t count = memory.size();
+	for (size_t i = 0U; i < count; i++)
+	{
+		size_t j = i + (size_t)std::rand() % (count - i);
+		std::swap(memory[i], memory[j]);
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page->free_blocks, initial_free_blocks);
+
+	/*a large power-of-two block can be allocated again*/
+	void* big = heap.malloc(65536U);
+	EXPECT_TRUE(big != nullptr);
+	heap.free(big);
+	EXPECT_EQ(page->free_blocks, initial_free_blocks);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapSizeClasses)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	/*block sizes must be aligned and not larger than RTSHA_MAX_FIXED_BLOCK_SIZE*/
+	EXPECT_FALSE(heap.add_page(NULL, static_cast<rtsha_page_size_type>(73U), 65536U));
+	EXPECT_FALSE(heap.add_page(NULL, static_cast<rtsha_page_size_type>(2U * RTSHA_MAX_FIXED_BLOCK_SIZE), 65536U));
+
+	/*the pages are added in any order*/
+	const size_t classes[] = { 1024U, 160U, 48U, 96U, 80U };
+	for (size_t block_size : classes)
+	{
+		EXPECT_TRUE(heap.add_page(NULL, static_cast<rtsha_page_size_type>(block_size), 65536U));
+	}
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+
+	EXPECT_EQ(heap.select_fixed_page(1U)->flags, 48U);
+	EXPECT_EQ(heap.select_fixed_page(48U)->flags, 48U);
+	EXPECT_EQ(heap.select_fixed_page(49U)->flags, 80U);
+	EXPECT_EQ(heap.select_fixed_page(81U)->flags, 96U);
+	EXPECT_EQ(heap.select_fixed_page(97U)->flags, 160U);
+	EXPECT_EQ(heap.select_fixed_page(161U)->flags, 1024U);
+	EXPECT_EQ(heap.select_fixed_page(1025U), nullptr);
+
+	/*every request is placed on the smallest class which can hold it with the block header*/
+	const size_t overhead = sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE;
+	const size_t requests[] = { 8U, 48U - overhead, 72U, 96U - overhead, 100U, 600U, 2000U };
+	for (size_t request : requests)
+	{
+		void* ptr = heap.malloc(request);
+		EXPECT_TRUE(ptr != nullptr);
+		rtsha_page* page = heap.get_block_page((address_t)ptr);
+		EXPECT_TRUE(page != nullptr);
+		rtsha_page* expected = heap.select_fixed_page(request + overhead);
+		if (expected != nullptr)
+		{
+			EXPECT_EQ(page, expected);
+		}
+		else
+		{
+			EXPECT_EQ(page, heap.get_big_memorypage());
+		}
+		heap.free(ptr);
+	}
+
+	free(heapMemory);
+}
+
+struct PoolMessage
+{
+	PoolMessage(uint32_t id, double value) noexcept : id(id), value(value)
+	{
+		instances++;
+	}
+
+	~PoolMessage() noexcept
+	{
+		instances--;
+	}
+
+	uint32_t	id;
+	double		value;
+	uint8_t		payload[40];
+
+	static size_t instances;
+};
+
+size_t PoolMessage::instances = 0U;
+
+TEST(TestCaseClassHeap, TestHeapObjectPool)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType128, 65536U));
+
+	ObjectPool<PoolMessage> pool(heap, 65536U);
+	EXPECT_TRUE(pool.is_valid());
+	EXPECT_EQ(pool.page()->flags, ObjectPool<PoolMessage>::BLOCK_SIZE);
+	EXPECT_TRUE(ObjectPool<PoolMessage>::BLOCK_SIZE >= (sizeof(PoolMessage) + sizeof(rtsha_block)));
+
+	/*the dedicated page is not used by malloc*/
+	EXPECT_EQ(heap.select_fixed_page(ObjectPool<PoolMessage>::BLOCK_SIZE)->flags, 128U);
+	void* ptr = heap.malloc(sizeof(PoolMessage));
+	EXPECT_TRUE(ptr != nullptr);
+	EXPECT_EQ(heap.get_block_page((address_t)ptr)->flags, 128U);
+	heap.free(ptr);
+
+	std::vector<PoolMessage*> messages;
+	for (uint32_t i = 0U; ; i++)
+	{
+		PoolMessage* message = pool.create(i, 0.5 * i);
+		if (message == nullptr)
+		{
+			break;
+		}
+		EXPECT_EQ(heap.get_block_page((address_t)message), pool.page());
+		EXPECT_EQ(((address_t)message) % alignof(PoolMessage), 0U);
+		messages.push_back(message);
+	}
+	EXPECT_EQ(messages.size(), (65536U - sizeof(rtsha_page) - 1U) / ObjectPool<PoolMessage>::BLOCK_SIZE);
+	EXPECT_EQ(PoolMessage::instances, messages.size());
+	for (uint32_t i = 0U; i < messages.size(); i++)
+	{
+		EXPECT_EQ(messages[i]->id, i);
+		EXPECT_EQ(messages[i]->value, 0.5 * i);
+	}
+
+	/*the released blocks are reused*/
+	PoolMessage* last = messages.back();
+	messages.pop_back();
+	pool.destroy(last);
+	EXPECT_EQ(PoolMessage::instances, messages.size());
+	PoolMessage* again = pool.create(7U, 1.0);
+	EXPECT_EQ(again, last);
+	messages.push_back(again);
+
+	for (PoolMessage* message : messages)
+	{
+		pool.destroy(message);
+	}
+	EXPECT_EQ(PoolMessage::instances, 0U);
+	pool.destroy(nullptr);
+
+	/*block sizes of a dedicated page must be aligned*/
+	EXPECT_EQ(heap.add_pool_page(NULL, 65536U, 73U), nullptr);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapArenaPage)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	rtsha_page* arena = heap.add_arena_page(NULL, 65536U);
+	EXPECT_TRUE(arena != nullptr);
+	EXPECT_EQ(heap.arena_malloc(heap.get_big_memorypage(), 16U), nullptr);
+
+	/*the blocks follow each other without headers*/
+	const address_t start = heap.arena_marker(arena);
+	char* first = reinterpret_cast<char*>(heap.arena_malloc(arena, 10U));
+	char* second = reinterpret_cast<char*>(heap.arena_malloc(arena, 24U));
+	EXPECT_EQ((address_t)first, start);
+	EXPECT_EQ((address_t)second, start + rtsha_align(10U, RTSHA_ALIGMENT));
+	void* aligned = heap.arena_malloc(arena, 8U, 64U);
+	EXPECT_EQ(((address_t)aligned) % 64U, 0U);
+	EXPECT_EQ(heap.arena_malloc(arena, 8U, 24U), nullptr);
+	::memset(first, 0xAB, 10U);
+	EXPECT_TRUE(heap.memset(second, 0, 24U) != nullptr);
+	EXPECT_EQ(heap.memset(second, 0, 65536U), nullptr);
+
+	/*malloc does not use the arena and free ignores its blocks*/
+	void* ptr = heap.malloc(1000U);
+	EXPECT_EQ(heap.get_block_page((address_t)ptr), heap.get_big_memorypage());
+	heap.free(ptr);
+	heap.free(second);
+	EXPECT_EQ(heap.realloc(second, 100U), nullptr);
+
+	/*nested scope*/
+	const address_t marker = heap.arena_marker(arena);
+	void* scratch = heap.arena_malloc(arena, 1000U);
+	EXPECT_TRUE(scratch != nullptr);
+	EXPECT_TRUE(heap.arena_rewind(arena, marker));
+	EXPECT_EQ(heap.arena_malloc(arena, 1000U), scratch);
+	EXPECT_FALSE(heap.arena_rewind(arena, heap.arena_marker(arena) + 8U));
+
+	/*the walk reports the used area and the rest of the page*/
+	size_t sizes[2] = { 0U, 0U };
+	heap.walk([](const rtsha_block_info& info, void* context) -> bool
+		{
+			if (info.page_type == rtsha_page_size_type::PageTypeArena)
+			{
+				size_t* sizes = reinterpret_cast<size_t*>(context);
+				sizes[info.free ? 1U : 0U] += info.size;
+			}
+			return true;
+		}, reinterpret_cast<void*>(sizes));
+	EXPECT_EQ(sizes[0], heap.arena_marker(arena) - start);
+	EXPECT_EQ(sizes[0] + sizes[1], arena->end_position - start);
+
+	/*fill the page, then release everything at once*/
+	size_t count = 0U;
+	while (heap.arena_malloc(arena, 100U) != nullptr)
+	{
+		count++;
+	}
+	EXPECT_TRUE(count > 600U);
+	EXPECT_TRUE(heap.arena_reset(arena));
+	EXPECT_EQ(heap.arena_marker(arena), start);
+	EXPECT_EQ(heap.arena_malloc(arena, 10U), first);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapMemoryResource)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType256, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType512, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	rtsha_page* arena = heap.add_arena_page(NULL, 65536U);
+	EXPECT_TRUE(arena != nullptr);
+
+	/*heap resource: the blocks are released on the page of their size class*/
+	heap_resource heap_res(heap);
+	void* small = heap_res.allocate(24U, alignof(size_t));
+	EXPECT_EQ(heap.get_block_page((address_t)small)->flags, 64U);
+	void* aligned = heap_res.allocate(100U, 64U);
+	EXPECT_EQ(((address_t)aligned) % 64U, 0U);
+	heap_res.deallocate(aligned, 100U, 64U);
+	heap_res.deallocate(small, 24U, alignof(size_t));
+	EXPECT_EQ(heap.malloc(24U), small);
+	heap.free(small);
+
+	{
+		std::pmr::vector<int> values(&heap_res);
+		for (int i = 0; i < 1000; i++)
+		{
+			values.push_back(i);
+		}
+		EXPECT_EQ(heap.get_block_page((address_t)values.data()), heap.get_big_memorypage());
+		std::pmr::map<int, int> map(&heap_res);
+		for (int i = 0; i < 100; i++)
+		{
+			map[i] = values[i];
+		}
+		EXPECT_EQ(map[99], 99);
+	}
+
+	/*page resource on an arena, chained with a monotonic buffer*/
+	page_resource arena_res(heap, arena);
+	EXPECT_TRUE(arena_res.is_equal(arena_res));
+	EXPECT_FALSE(arena_res.is_equal(heap_res));
+	{
+		std::pmr::monotonic_buffer_resource monotonic(1024U, &arena_res);
+		std::pmr::vector<int> values(&monotonic);
+		for (int i = 0; i < 1000; i++)
+		{
+			values.push_back(i);
+		}
+		EXPECT_EQ(heap.get_block_page((address_t)values.data()), arena);
+	}
+	EXPECT_TRUE(heap.arena_reset(arena));
+
+	/*page resource on a fixed size page*/
+	rtsha_page* fixed = heap.select_fixed_page(64U);
+	page_resource fixed_res(heap, fixed);
+	void* block = fixed_res.allocate(40U, alignof(size_t));
+	EXPECT_EQ(heap.get_block_page((address_t)block), fixed);
+	fixed_res.deallocate(block, 40U, alignof(size_t));
+	EXPECT_EQ(fixed_res.allocate(40U, alignof(size_t)), block);
+	fixed_res.deallocate(block, 40U, alignof(size_t));
+	EXPECT_EQ(heap.page_malloc(fixed, 100U), nullptr);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapNodeAllocator)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	const size_t classes[] = { 48U, 64U, 80U, 96U };
+	for (size_t block_size : classes)
+	{
+		EXPECT_TRUE(heap.add_page(NULL, static_cast<rtsha_page_size_type>(block_size), 4U * 65536U));
+	}
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 4U * 65536U));
+
+	/*every node is placed on the page of its size class*/
+	auto on_size_class = [&heap](const void* node, size_t node_size) -> bool
+		{
+			rtsha_page* page = heap.get_block_page((address_t)node);
+			return (page != nullptr) && (page == heap.select_fixed_page(node_size + sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE));
+		};
+
+	NodeAllocator<int> allocator(heap);
+	{
+		std::list<int, NodeAllocator<int>> list(allocator);
+		std::forward_list<int, NodeAllocator<int>> forward_list(allocator);
+		std::set<int, std::less<int>, NodeAllocator<int>> set(allocator);
+		std::map<int, double, std::less<int>, NodeAllocator<std::pair<const int, double>>> map(allocator);
+		for (int i = 0; i < 1000; i++)
+		{
+			list.push_back(i);
+			forward_list.push_front(i);
+			set.insert(i);
+			map[i] = 0.5 * i;
+		}
+		EXPECT_EQ(list.size(), 1000U);
+		EXPECT_EQ(set.size(), 1000U);
+		EXPECT_EQ(map[999], 499.5);
+
+		const size_t list_node = sizeof(int) + 2U * sizeof(void*);
+		EXPECT_TRUE(on_size_class(reinterpret_cast<const char*>(&list.front()) - 2U * sizeof(void*), list_node));
+		EXPECT_TRUE(on_size_class(reinterpret_cast<const char*>(&forward_list.front()) - sizeof(void*), sizeof(int) + sizeof(void*)));
+
+		for (int i = 0; i < 500; i++)
+		{
+			list.pop_front();
+			forward_list.pop_front();
+			set.erase(i);
+			map.erase(i);
+		}
+		EXPECT_EQ(*set.begin(), 500);
+		EXPECT_EQ(map.begin()->second, 250.0);
+	}
+
+	/*all nodes have been returned to their pages*/
+	for (size_t block_size : classes)
+	{
+		rtsha_page* page = heap.select_fixed_page(block_size);
+		EXPECT_EQ(page->free_blocks * block_size, page->position - page->start_position);
+	}
+
+	/*a forward list on a single variable size page*/
+	TLSFMemoryPage tlsf_page(heap.select_page(rtsha_page_size_type::PageTypeTLSF, 0U));
+	{
+		ForwardListAllocator<int> list_allocator(tlsf_page);
+		std::forward_list<int, ForwardListAllocator<int>> forward_list(list_allocator);
+		for (int i = 0; i < 100; i++)
+		{
+			forward_list.push_front(i);
+		}
+		EXPECT_EQ(forward_list.front(), 99);
+		EXPECT_EQ(heap.get_block_page((address_t)&forward_list.front())->flags, static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF));
+	}
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapGrowth)
+{
+	RegionProviderStruct provider;
+	if (!rtsha_mmap_region_provider(&provider))
+	{
+		GTEST_SKIP() << "no virtual memory on this target";
+	}
+
+	const size_t max_size = 16U * 1024U * 1024U;
+	Heap heap;
+	EXPECT_TRUE(heap.init(&provider, 65536U, max_size));
+	EXPECT_EQ(heap.get_free_space(), max_size);
+
+	/*the pages are committed on demand*/
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 4096U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 4U * 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 65536U));
+	EXPECT_FALSE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 2U * max_size));
+
+	/*without growth the size class runs out*/
+	std::vector<void*> blocks;
+	void* ptr = nullptr;
+	while ((ptr = heap.malloc(32U)) != nullptr)
+	{
+		blocks.push_back(ptr);
+	}
+	EXPECT_EQ(blocks.size(), (4096U - sizeof(rtsha_page) - 1U) / 64U);
+
+	/*new pages of the class are appended*/
+	heap.set_page_growth(16384U);
+	for (size_t i = 0U; i < 2000U; i++)
+	{
+		ptr = heap.malloc(32U);
+		EXPECT_TRUE(ptr != nullptr);
+		EXPECT_EQ(heap.get_block_page((address_t)ptr)->flags, 64U);
+		blocks.push_back(ptr);
+	}
+	rtsha_page* current = heap.select_fixed_page(64U);
+	EXPECT_TRUE(current->map_page != nullptr);
+
+	/*a block released on a previous page of the class is used again when the current page is full*/
+	void* first = blocks.front();
+	heap.free(first);
+	while ((current->free_blocks > 0U) || (current->position < current->end_position - 64U))
+	{
+		blocks.push_back(heap.malloc(32U));
+	}
+	EXPECT_EQ(heap.malloc(32U), first);
+
+	/*variable blocks get a new TLSF page*/
+	heap.set_page_growth(1024U * 1024U);
+	std::vector<void*> big_blocks;
+	for (size_t i = 0U; i < 40U; i++)
+	{
+		ptr = heap.malloc(20000U);
+		EXPECT_TRUE(ptr != nullptr);
+		big_blocks.push_back(ptr);
+	}
+	for (void* block : big_blocks)
+	{
+		heap.free(block);
+	}
+
+	/*the hard cap is never exceeded*/
+	Heap capped;
+	EXPECT_TRUE(capped.init(&provider, 4096U, 262144U));
+	EXPECT_TRUE(capped.add_page(NULL, rtsha_page_size_type::PageType64, 4096U));
+	capped.set_page_growth(65536U);
+	size_t count = 0U;
+	while (capped.malloc(32U) != nullptr)
+	{
+		count++;
+	}
+	EXPECT_TRUE(count > (3U * 65536U) / 64U);
+	EXPECT_TRUE(count < 262144U / 64U);
+	EXPECT_EQ(capped.get_free_space(), 262144U - (4096U + 3U * 65536U));
+
+	/*a page ending just beyond the committed memory is committed completely*/
+	Heap boundary;
+	EXPECT_TRUE(boundary.init(&provider, 65536U, 1024U * 1024U));
+	const size_t boundary_size = 65536U + sizeof(rtsha_page) - 8U;
+	EXPECT_TRUE(boundary.add_page(NULL, rtsha_page_size_type::PageType64, boundary_size));
+	count = 0U;
+	while (boundary.malloc(40U) != nullptr)
+	{
+		count++;
+	}
+	EXPECT_EQ(count, (boundary_size - sizeof(rtsha_page) - 1U) / 64U);
+}
+
+static size_t zero_calls = 0U;
+
+static void zero_parallel(void* address, size_t size)
+{
+	/*the range is split across four worker threads*/
+	const size_t part = rtsha_align(size / 4U, sizeof(size_t));
+	std::vector<std::thread> workers;
+	for (size_t offset = 0U; offset < size; offset += part)
+	{
+		const size_t length = ((size - offset) < part) ? (size - offset) : part;
+		workers.emplace_back([=]() { memset((uint8_t*)address + offset, 0, length); });
+	}
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+	zero_calls++;
+}
+
+static bool is_filled(const void* ptr, size_t size, uint8_t value)
+{
+	const uint8_t* bytes = (const uint8_t*)ptr;
+	for (size_t i = 0U; i < size; i++)
+	{
+		if (bytes[i] != value)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+TEST(TestCaseClassHeap, TestHeapInitMode)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+	uint8_t* end = (uint8_t*)heapMemory + size;
+
+	/*the whole heap is set to zero at once*/
+	memset(heapMemory, 0xA5, size);
+	Heap zeroed;
+	EXPECT_TRUE(zeroed.init(heapMemory, size, rtsha_init_mode::InitZeroHeap, zero_parallel));
+	EXPECT_EQ(zero_calls, 1U);
+	EXPECT_TRUE(is_filled(heapMemory, size, 0U));
+
+	/*only the page headers and the metadata are written*/
+	memset(heapMemory, 0xA5, size);
+	Heap untouched;
+	EXPECT_TRUE(untouched.init(heapMemory, size, rtsha_init_mode::InitNoZero));
+	EXPECT_TRUE(untouched.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(untouched.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 4U * 65536U));
+	EXPECT_TRUE(is_filled(end - 65536U, 65536U, 0xA5));
+	void* small = untouched.malloc(32U);
+	void* big = untouched.malloc(1000U);
+	EXPECT_TRUE((small != nullptr) && (big != nullptr));
+	untouched.free(small);
+	untouched.free(big);
+	EXPECT_EQ(untouched.malloc(32U), small);
+
+	/*the pages are set to zero when they are added, the blocks of fixed size pages when they are allocated*/
+	memset(heapMemory, 0xA5, size);
+	Heap lazy;
+	EXPECT_TRUE(lazy.init(heapMemory, size, rtsha_init_mode::InitZeroPages, zero_parallel));
+	EXPECT_EQ(zero_calls, 1U);
+	EXPECT_TRUE(lazy.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_EQ(zero_calls, 1U);
+	EXPECT_TRUE(lazy.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 4U * 65536U));
+	EXPECT_EQ(zero_calls, 2U);
+	EXPECT_TRUE(is_filled(end - 65536U, 65536U, 0xA5));
+
+	rtsha_page* page = lazy.select_fixed_page(64U);
+	EXPECT_TRUE(is_filled((void*)page->position, 64U, 0xA5));
+	small = lazy.malloc(32U);
+	EXPECT_TRUE(small != nullptr);
+	EXPECT_TRUE(is_filled(small, 32U, 0U));
+	EXPECT_TRUE(is_filled((void*)page->position, 64U, 0xA5));
+	big = lazy.malloc(1000U);
+	EXPECT_TRUE(big != nullptr);
+	/*the free list links of the page are stored in the first bytes of a free block*/
+	EXPECT_TRUE(is_filled((uint8_t*)big + 64U, 1000U - 64U, 0U));
+	lazy.free(small);
+	lazy.free(big);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapWarmUp)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType256, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypePowerTwo, 8U * 65536U, 0U, 32U, 2048U));
+
+	rtsha_page* fixed_page = heap.select_fixed_page(256U);
+	rtsha_page* page = heap.select_page(rtsha_page_size_type::PageTypePowerTwo, 1024U, true);
+	EXPECT_TRUE((fixed_page != nullptr) && (page != nullptr));
+
+	const rtsha_warm_up_entry plan[] = { {200U, 100U}, {1000U, 50U} };
+	EXPECT_TRUE(heap.warm_up(plan, 2U));
+	EXPECT_EQ(fixed_page->free_blocks, 100U);
+	EXPECT_TRUE(page->free_blocks >= 50U);
+
+	/*the blocks are taken from the free lists, nothing is split or carved*/
+	const address_t position = fixed_page->position;
+	std::vector<void*> blocks;
+	for (size_t i = 0U; i < 100U; i++)
+	{
+		blocks.push_back(heap.malloc(200U));
+		EXPECT_EQ(fixed_page->free_blocks, 99U - i);
+	}
+	EXPECT_EQ(fixed_page->position, position);
+	for (size_t i = 0U; i < 50U; i++)
+	{
+		const size_t free_blocks = page->free_blocks;
+		void* ptr = heap.malloc(1000U);
+		EXPECT_TRUE(ptr != nullptr);
+		EXPECT_EQ(page->free_blocks, free_blocks - 1U);
+		blocks.push_back(ptr);
+	}
+	for (void* block : blocks)
+	{
+		heap.free(block);
+	}
+
+	/*the plan does not fit into the heap*/
+	const rtsha_warm_up_entry too_large[] = { {200U, 1000U} };
+	EXPECT_FALSE(heap.warm_up(too_large, 1U));
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapReservation)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 4096U));
+	rtsha_page* page = heap.select_fixed_page(64U);
+	const size_t page_blocks = (4096U - sizeof(rtsha_page) - 1U) / 64U;
+
+	rtsha_reservation token;
+	EXPECT_TRUE(heap.reserve(32U, 8U, token));
+	EXPECT_TRUE(heap.reserve(32U, 2U, token));
+	EXPECT_EQ(token.page, page);
+	EXPECT_EQ(token.count, 10U);
+	EXPECT_EQ(page->reserved_blocks, 10U);
+
+	/*only variable pages can hold larger blocks*/
+	rtsha_reservation big_token;
+	EXPECT_FALSE(heap.reserve(5000U, 1U, big_token));
+	EXPECT_TRUE(big_token.page == nullptr);
+
+	/*malloc does not take the reserved blocks*/
+	std::vector<void*> blocks;
+	void* ptr = nullptr;
+	while ((ptr = heap.malloc(32U)) != nullptr)
+	{
+		blocks.push_back(ptr);
+	}
+	EXPECT_EQ(blocks.size(), page_blocks - 10U);
+	rtsha_reservation other;
+	EXPECT_FALSE(heap.reserve(32U, 1U, other));
+
+	std::vector<void*> reserved;
+	for (size_t i = 0U; i < 10U; i++)
+	{
+		ptr = heap.malloc_reserved(token);
+		EXPECT_TRUE(ptr != nullptr);
+		reserved.push_back(ptr);
+	}
+	EXPECT_EQ(token.count, 0U);
+	EXPECT_EQ(token.in_use, 10U);
+	EXPECT_TRUE(heap.malloc_reserved(token) == nullptr);
+
+	/*a released block returns to the reservation*/
+	heap.free_reserved(token, reserved.back());
+	EXPECT_EQ(token.count, 1U);
+	EXPECT_TRUE(heap.malloc(32U) == nullptr);
+	EXPECT_EQ(heap.malloc_reserved(token), reserved.back());
+
+	/*a block allocated by malloc does not extend the reservation*/
+	for (void* block : reserved)
+	{
+		heap.free_reserved(token, block);
+	}
+	EXPECT_EQ(token.count, 10U);
+	EXPECT_EQ(token.in_use, 0U);
+	heap.free_reserved(token, blocks.back());
+	EXPECT_EQ(token.count, 10U);
+	EXPECT_EQ(page->reserved_blocks, 10U);
+	EXPECT_TRUE(heap.malloc(32U) == nullptr);
+	for (size_t i = 0U; i < 10U; i++)
+	{
+		reserved[i] = heap.malloc_reserved(token);
+		EXPECT_TRUE(reserved[i] != nullptr);
+	}
+	EXPECT_TRUE(heap.malloc_reserved(token) == nullptr);
+
+	/*the blocks not in use are given back to malloc*/
+	heap.free_reserved(token, reserved[0]);
+	heap.free_reserved(token, reserved[1]);
+	heap.release_reservation(token);
+	EXPECT_TRUE(token.page == nullptr);
+	EXPECT_EQ(page->reserved_blocks, 0U);
+	EXPECT_TRUE(heap.malloc(32U) != nullptr);
+	EXPECT_TRUE(heap.malloc(32U) != nullptr);
+	EXPECT_TRUE(heap.malloc(32U) == nullptr);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapMemoryKernels)
+{
+	std::vector<uint8_t> src(1024U + 64U);
+	std::vector<uint8_t> dst(1024U + 64U);
+	std::vector<uint8_t> expected(1024U + 64U);
+	for (size_t i = 0U; i < src.size(); i++)
+	{
+		src[i] = static_cast<uint8_t>(i * 7U + 3U);
+	}
+	EXPECT_TRUE(rtsha_kernel_name() != nullptr);
+
+	/*every size and alignment of the prologue and epilogue, the bytes around the area stay untouched*/
+	const size_t sizes[] = { 0U, 1U, 3U, 4U, 7U, 8U, 15U, 16U, 17U, 31U, 32U, 33U, 63U, 64U, 65U, 127U, 128U, 129U, 200U, 255U, 256U, 300U, 1000U };
+	for (size_t size : sizes)
+	{
+		for (size_t src_offset = 0U; src_offset < 16U; src_offset++)
+		{
+			for (size_t dst_offset = 0U; dst_offset < 16U; dst_offset++)
+			{
+				std::fill(dst.begin(), dst.end(), 0xEEU);
+				expected = dst;
+				::memcpy(expected.data() + dst_offset, src.data() + src_offset, size);
+				EXPECT_EQ(rtsha_copy(dst.data() + dst_offset, src.data() + src_offset, size), dst.data() + dst_offset);
+				EXPECT_TRUE(dst == expected);
+			}
+			std::fill(dst.begin(), dst.end(), 0xEEU);
+			expected = dst;
+			::memset(expected.data() + src_offset, 0x5A, size);
+			EXPECT_EQ(rtsha_fill(dst.data() + src_offset, 0x5A, size), dst.data() + src_offset);
+			EXPECT_TRUE(dst == expected);
+		}
+	}
+
+	/*the streaming kernels write around the caches, the result is the same*/
+	for (size_t size : sizes)
+	{
+		for (size_t offset = 0U; offset < 16U; offset++)
+		{
+			std::fill(dst.begin(), dst.end(), 0xEEU);
+			expected = dst;
+			::memcpy(expected.data() + offset, src.data() + 15U - offset, size);
+			EXPECT_EQ(rtsha_copy_stream(dst.data() + offset, src.data() + 15U - offset, size), dst.data() + offset);
+			EXPECT_TRUE(dst == expected);
+
+			std::fill(dst.begin(), dst.end(), 0xEEU);
+			expected = dst;
+			::memset(expected.data() + offset, 0, size);
+			EXPECT_EQ(rtsha_fill_stream(dst.data() + offset, 0, size), dst.data() + offset);
+			EXPECT_TRUE(dst == expected);
+		}
+	}
+
+	/*the checked heap functions use the same kernels*/
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	uint8_t* block = static_cast<uint8_t*>(heap.malloc(1000U));
+	EXPECT_TRUE(block != nullptr);
+	EXPECT_EQ(heap.memcpy(block, src.data(), 1000U), block);
+	EXPECT_EQ(0, ::memcmp(block, src.data(), 1000U));
+	EXPECT_EQ(heap.memset(block, 0x11, 1000U), block);
+	for (size_t i = 0U; i < 1000U; i++)
+	{
+		EXPECT_EQ(block[i], 0x11U);
+	}
+
+	/*copies from the threshold on use the streaming kernels*/
+	heap.set_stream_threshold(512U);
+	EXPECT_EQ(heap.memset(block, 0x22, 1000U), block);
+	EXPECT_EQ(block[999], 0x22U);
+	EXPECT_EQ(heap.memcpy(block, src.data(), 1000U), block);
+	EXPECT_EQ(0, ::memcmp(block, src.data(), 1000U));
+	heap.free(block);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseMyMalloc, TestMyMallocPerformanceMemoryKernels)
+{
+	/*throughput of the kernels compared to libc, the result is printed and not checked*/
+	const size_t sizes[] = { 64U, 4096U, 1024U * 1024U };
+	std::vector<uint8_t> src(1024U * 1024U + 64U, 0x5AU);
+	std::vector<uint8_t> dst(1024U * 1024U + 64U, 0U);
+	std::cout << "memory kernels: " << rtsha_kernel_name() << std::endl;
+
+	for (size_t size : sizes)
+	{
+		const size_t iterations = std::max(static_cast<size_t>(16U), (64U * 1024U * 1024U) / size);
+		double results[4];
+		for (size_t variant = 0U; variant < 4U; variant++)
+		{
+			auto start = high_resolution_clock::now();
+			for (size_t i = 0U; i < iterations; i++)
+			{
+				/*the offset changes the alignment of the destination*/
+				uint8_t* d = dst.data() + (i % 4U) * 8U;
+				switch (variant)
+				{
+				case 0U:
+					::memcpy(d, src.data(), size);
+					break;
+				case 1U:
+					rtsha_copy(d, src.data(), size);
+					break;
+				case 2U:
+					::memset(d, static_cast<int>(i), size);
+					break;
+				default:
+					rtsha_fill(d, static_cast<int>(i), size);
+					break;
+				}
+			}
+			auto stop = high_resolution_clock::now();
+			const double seconds = duration_cast<duration<double>>(stop - start).count();
+			results[variant] = (seconds > 0.0) ? (static_cast<double>(size) * static_cast<double>(iterations)) / (seconds * 1024.0 * 1024.0 * 1024.0) : 0.0;
+		}
+		std::cout << "size " << size << " B: memcpy " << results[0] << " GB/s, rtsha_copy " << results[1]
+			<< " GB/s, memset " << results[2] << " GB/s, rtsha_fill " << results[3] << " GB/s" << std::endl;
+	}
+	/*the last fill has set the whole range*/
+	EXPECT_EQ(dst[0], dst[1]);
+}
+
+TEST(TestCaseClassHeap, TestHeapBlockRef)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 4096U));
+
+	uint8_t* large = static_cast<uint8_t*>(heap.malloc(1000U));
+	uint8_t* small = static_cast<uint8_t*>(heap.malloc(32U));
+	EXPECT_TRUE((large != nullptr) && (small != nullptr));
+
+	/*the source is checked as well: a small source block can not fill a large destination*/
+	EXPECT_TRUE(heap.memcpy(large, small, 32U) != nullptr);
+	EXPECT_TRUE(heap.memcpy(large, small, 500U) == nullptr);
+	EXPECT_TRUE(heap.memcpy(small, large, 500U) == nullptr);
+
+	rtsha_block_ref large_ref;
+	rtsha_block_ref small_ref;
+	EXPECT_TRUE(heap.get_block_ref(large, large_ref));
+	EXPECT_TRUE(heap.get_block_ref(small, small_ref));
+	EXPECT_EQ(large_ref.data, (address_t)large);
+	EXPECT_GE(large_ref.size, 1000U);
+	EXPECT_GE(small_ref.size, 32U);
+	EXPECT_LT(small_ref.size, 64U);
+
+	/*buffers outside of the heap are described directly*/
+	uint8_t buffer[256];
+	for (size_t i = 0U; i < sizeof(buffer); i++)
+	{
+		buffer[i] = static_cast<uint8_t>(i);
+	}
+	rtsha_block_ref buffer_ref;
+	buffer_ref.data = (address_t)buffer;
+	buffer_ref.size = sizeof(buffer);
+
+	EXPECT_EQ(heap.memset(large_ref, 0U, 0, large_ref.size), large);
+	EXPECT_EQ(heap.memcpy(large_ref, 100U, buffer_ref, 0U, sizeof(buffer)), large + 100U);
+	EXPECT_EQ(0, ::memcmp(large + 100U, buffer, sizeof(buffer)));
+	EXPECT_EQ(large[99], 0U);
+	EXPECT_EQ(heap.memcpy(small_ref, 0U, large_ref, 100U, 32U), small);
+	EXPECT_EQ(0, ::memcmp(small, buffer, 32U));
+	EXPECT_EQ(heap.memset(small_ref, 16U, 0x77, 16U), small + 16U);
+	EXPECT_EQ(small[16], 0x77U);
+
+	/*ranges exceeding a block are rejected*/
+	EXPECT_TRUE(heap.memcpy(small_ref, 0U, large_ref, 0U, 500U) == nullptr);
+	EXPECT_TRUE(heap.memcpy(large_ref, large_ref.size - 10U, buffer_ref, 0U, 11U) == nullptr);
+	EXPECT_TRUE(heap.memcpy(large_ref, 0U, buffer_ref, 250U, 10U) == nullptr);
+	EXPECT_TRUE(heap.memset(small_ref, small_ref.size + 1U, 0, 1U) == nullptr);
+	EXPECT_TRUE(heap.memset(small_ref, 1U, 0, SIZE_MAX) == nullptr);
+
+	/*a free block or an address within a block can not be referenced*/
+	rtsha_block_ref ref;
+	EXPECT_FALSE(heap.get_block_ref(large + 8U, ref));
+	heap.free(small);
+	EXPECT_FALSE(heap.get_block_ref(small, ref));
+	EXPECT_EQ(ref.data, 0U);
+	EXPECT_TRUE(heap.memset(ref, 0U, 0, 1U) == nullptr);
+	heap.free(large);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapMappedRegion)
+{
+	RegionProviderStruct provider;
+	if (!rtsha_mmap_region_provider(&provider))
+	{
+		GTEST_SKIP() << "no virtual memory on this target";
+	}
+
+	/*the committed memory is faulted in at once*/
+	Heap heap;
+	EXPECT_TRUE(heap.init_mapped(65536U, 16U * 1024U * 1024U, RTSHA_MMAP_POPULATE));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 4U * 65536U));
+	void* ptr = heap.malloc(32U);
+	EXPECT_TRUE(ptr != nullptr);
+	heap.free(ptr);
+	EXPECT_FALSE(heap.init_mapped(65536U, 16U * 1024U * 1024U, RTSHA_MMAP_POPULATE));
+
+	/*the huge page backed region starts at a huge page boundary and grows by whole huge pages*/
+	const size_t huge_size = rtsha_huge_page_size();
+	if (huge_size == 0U)
+	{
+		GTEST_SKIP() << "no huge pages on this target";
+	}
+	Heap huge;
+	EXPECT_TRUE(huge.init_mapped(4096U, 8U * huge_size, RTSHA_MMAP_HUGE_PAGES | RTSHA_MMAP_POPULATE));
+	EXPECT_EQ(huge.get_free_space(), 8U * huge_size);
+	EXPECT_TRUE(huge.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(huge.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, huge_size));
+	rtsha_page* page = huge.select_fixed_page(64U);
+	EXPECT_EQ(((address_t)page) % huge_size, 0U);
+	std::vector<void*> blocks;
+	for (size_t i = 0U; i < 100U; i++)
+	{
+		ptr = huge.malloc(1000U + i);
+		EXPECT_TRUE(ptr != nullptr);
+		huge.memset(ptr, 0xAA, 1000U + i);
+		blocks.push_back(ptr);
+	}
+	for (void* block : blocks)
+	{
+		huge.free(block);
+	}
+
+	/*locking fails when the memory lock limit of the process is too low*/
+	Heap locked;
+	if (!locked.init_mapped(65536U, 1024U * 1024U, RTSHA_MMAP_LOCK))
+	{
+		GTEST_SKIP() << "the memory can not be locked";
+	}
+	EXPECT_TRUE(locked.add_page(NULL, rtsha_page_size_type::PageType64, 32768U));
+	EXPECT_TRUE(locked.malloc(32U) != nullptr);
+}
+
+TEST(TestCaseClassHeap, TestHeapRebalance)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 4096U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType256, 4U * 65536U));
+
+	rtsha_page* page64 = heap.select_fixed_page(64U);
+	rtsha_page* page256 = heap.select_fixed_page(256U);
+	const address_t end256 = page256->end_position;
+
+	/*only the pages of a size class can be rebalanced*/
+	EXPECT_TRUE(heap.rebalance_page(heap.get_big_memorypage(), 16384U) == nullptr);
+	EXPECT_EQ(heap.rebalance(16384U, 16U), 0U);
+
+	std::vector<void*> blocks;
+	void* ptr = nullptr;
+	while ((ptr = heap.malloc(32U)) != nullptr)
+	{
+		blocks.push_back(ptr);
+	}
+	EXPECT_EQ(blocks.size(), (4096U - sizeof(rtsha_page) - 1U) / 64U);
+
+	/*the starved class gets a page from the untouched area of the 256 bytes class*/
+	void* block256 = heap.malloc(200U);
+	EXPECT_TRUE(block256 != nullptr);
+	EXPECT_EQ(heap.rebalance(16384U, 16U), 1U);
+	EXPECT_EQ(page256->end_position, end256 - 16384U);
+	rtsha_page* current = heap.select_fixed_page(64U);
+	EXPECT_TRUE(current != page64);
+	EXPECT_EQ(current->map_page, page64);
+	EXPECT_EQ((address_t)current, end256 - 16384U);
+	EXPECT_EQ(heap.rebalance(16384U, 16U), 0U);
+
+	ptr = heap.malloc(32U);
+	EXPECT_TRUE(ptr != nullptr);
+	EXPECT_EQ(heap.get_block_page((address_t)ptr), current);
+	blocks.push_back(ptr);
+
+	/*a block released on the previous page of the class is used again when the new page is full*/
+	void* first = blocks.front();
+	heap.free(first);
+	while ((current->free_blocks > 0U) || ((current->position + 64U) < current->end_position))
+	{
+		blocks.push_back(heap.malloc(32U));
+	}
+	EXPECT_EQ(heap.malloc(32U), first);
+	EXPECT_TRUE(heap.malloc(32U) == nullptr);
+
+	/*on demand*/
+	EXPECT_TRUE(heap.rebalance_page(current, 8192U) != nullptr);
+	EXPECT_EQ(page256->end_position, end256 - (16384U + 8192U));
+	EXPECT_TRUE(heap.malloc(32U) != nullptr);
+
+	/*the donor keeps its blocks and can not give more than its untouched area*/
+	EXPECT_EQ(heap.get_block_page((address_t)block256), page256);
+	heap.free(block256);
+	EXPECT_TRUE(heap.rebalance_page(heap.select_fixed_page(64U), 4U * 65536U) == nullptr);
+	EXPECT_EQ(heap.malloc(200U), block256);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapBlockHeader)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+	EXPECT_EQ(sizeof(rtsha_block), 2U * sizeof(uint32_t));
+#else
+	EXPECT_EQ(sizeof(rtsha_block), 2U * sizeof(size_t));
+#endif
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 65536U));
+
+	/*the blocks are linked to their predecessors*/
+	void* first = heap.malloc(1000U);
+	void* second = heap.malloc(2000U);
+	EXPECT_TRUE((first != nullptr) && (second != nullptr));
+
+	MemoryBlock block1(reinterpret_cast<rtsha_block*>(reinterpret_cast<size_t>(first) - sizeof(rtsha_block)));
+	MemoryBlock block2(reinterpret_cast<rtsha_block*>(reinterpret_cast<size_t>(second) - sizeof(rtsha_block)));
+	EXPECT_TRUE(block1.isValid());
+	EXPECT_TRUE(block2.isValid());
+	EXPECT_EQ(block1.getAllocAddress(), first);
+	EXPECT_EQ(block1.getNextBlock(), block2.getBlock());
+	EXPECT_EQ(block2.getPrev(), block1.getBlock());
+	EXPECT_EQ(block1.getSize(), rtsha_align(1000U + sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE, RTSHA_ALIGMENT));
+
+	heap.free(first);
+	heap.free(second);
+	free(heapMemory);
+}
+
 TEST(TestCaseMyMalloc, TestMyMallocPerformancePowerTwo1)
 {
 	size_t size = 0x1F4000*10;
@@ -800,3 +1873,498 @@ TEST(TestCaseMyMalloc, TestMyMallocPerformanceBigBlocks)
 		heap.free(memory4);
 	}		
 }
+
+struct WalkStatistics
+{
+	size_t blocks = 0U;
+	size_t free_blocks = 0U;
+	size_t used_bytes = 0U;
+};
+
+static bool countBlocks(const rtsha_block_info& info, void* context)
+{
+	WalkStatistics* stat = reinterpret_cast<WalkStatistics*>(context);
+	stat->blocks++;
+	if (info.free)
+	{
+		stat->free_blocks++;
+	}
+	else
+	{
+		stat->used_bytes += info.size;
+	}
+	return true;
+}
+
+TEST(TestCaseClassHeap, TestHeapPowerTwoBitmapPage)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	/*the page is too small for one top block*/
+	EXPECT_FALSE(heap.add_page(NULL, rtsha_page_size_type::PageTypePowerTwoBitmap, 4096U, 0U, 16U, 8192U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypePowerTwoBitmap, 4U * 65536U, 0U, 16U, 4096U));
+
+	/*the blocks have no header, 64 byte requests are placed next to each other*/
+	const size_t count = 512U;
+	void* memory[count];
+	for (size_t i = 0U; i < count; i++)
+	{
+		memory[i] = heap.malloc(64U);
+		EXPECT_TRUE(memory[i] != nullptr);
+		EXPECT_TRUE(heap.memset(memory[i], (int)(i & 0xFF), 64U) != nullptr);
+	}
+	rtsha_page* page = heap.get_block_page((address_t)memory[0]);
+	EXPECT_TRUE(page != nullptr);
+	for (size_t i = 1U; i < count; i++)
+	{
+		EXPECT_EQ(heap.get_block_page((address_t)memory[i]), page);
+		if ((i % 64U) != 0U)
+		{
+			EXPECT_EQ((size_t)memory[i] - (size_t)memory[i - 1U], 64U);
+		}
+	}
+	/*the size of the block is known without a header*/
+	EXPECT_EQ(heap.memset(memory[0], 0, 65U), nullptr);
+	EXPECT_EQ(heap.realloc(memory[1], 40U), memory[1]);
+	for (size_t i = 0U; i < count; i++)
+	{
+		uint8_t* data = reinterpret_cast<uint8_t*>(memory[i]);
+		EXPECT_EQ(data[63], (uint8_t)(i & 0xFF));
+	}
+
+	WalkStatistics used;
+	EXPECT_TRUE(heap.walk(countBlocks, &used));
+	EXPECT_EQ(used.used_bytes, count * 64U);
+
+	/*release in random order, the buddies are merged up to the top blocks*/
+	for (size_t i = 0U; i < count; i++)
+	{
+		size_t j = i + (size_t)std::rand() % (count - i);
+		std::swap(memory[i], memory[j]);
+		heap.free(memory[i]);
+	}
+	/*double free is detected*/
+	heap.free(memory[0]);
+	EXPECT_EQ(page->free_blocks, page->max_blocks / (page->max_block_size / page->min_block_size));
+
+	WalkStatistics all;
+	EXPECT_TRUE(heap.walk(countBlocks, &all));
+	EXPECT_EQ(all.blocks, page->free_blocks);
+	EXPECT_EQ(all.free_blocks, page->free_blocks);
+
+	/*the largest block can be allocated again*/
+	void* big = heap.malloc(4096U);
+	EXPECT_TRUE(big != nullptr);
+	EXPECT_EQ(heap.malloc(4097U), nullptr);
+	heap.free(big);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapFixedBitmapPage)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_FALSE(heap.add_page(NULL, rtsha_page_size_type::PageTypeFixedBitmap, 4096U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeFixedBitmap, 65536U, 0U, 0U, 64U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeFixedBitmap, 65536U, 0U, 0U, 32U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType256, 65536U));
+
+	/*larger requests skip the pages without block headers*/
+	void* large = heap.malloc(100U);
+	EXPECT_EQ(heap.get_block_page((address_t)large), heap.select_fixed_page(256U));
+	heap.free(large);
+
+	/*the smallest block size which can hold the request is used, the whole block holds data*/
+	void* small = heap.malloc(32U);
+	void* medium = heap.malloc(33U);
+	rtsha_page* page32 = heap.get_block_page((address_t)small);
+	rtsha_page* page64 = heap.get_block_page((address_t)medium);
+	EXPECT_TRUE((page32 != nullptr) && (page64 != nullptr));
+	EXPECT_EQ(page32->flags, static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap));
+	EXPECT_EQ(page32->max_block_size, 32U);
+	EXPECT_EQ(page64->max_block_size, 64U);
+	EXPECT_TRUE(heap.memset(small, 0x5A, 32U) != nullptr);
+	EXPECT_EQ(heap.memset(small, 0x5A, 33U), nullptr);
+	heap.free(small);
+	heap.free(medium);
+
+	/*the blocks are placed next to each other until the page is full*/
+	const size_t slots = page32->max_blocks;
+	EXPECT_EQ(page32->free_blocks, slots);
+	std::vector<void*> memory(slots);
+	for (size_t i = 0U; i < slots; i++)
+	{
+		memory[i] = heap.malloc(24U);
+		EXPECT_EQ(heap.get_block_page((address_t)memory[i]), page32);
+		if (i > 0U)
+		{
+			EXPECT_EQ((size_t)memory[i] - (size_t)memory[i - 1U], 32U);
+		}
+	}
+	EXPECT_EQ(page32->free_blocks, 0U);
+	/*the next request is served by the 64 byte page*/
+	void* next = heap.malloc(24U);
+	EXPECT_EQ(heap.get_block_page((address_t)next), page64);
+	heap.free(next);
+
+	WalkStatistics used;
+	EXPECT_TRUE(heap.walk(countBlocks, &used));
+	EXPECT_EQ(used.used_bytes, slots * 32U);
+
+	/*a released slot is reused first*/
+	heap.free(memory[slots / 2U]);
+	EXPECT_EQ(page32->free_blocks, 1U);
+	EXPECT_EQ(heap.malloc(8U), memory[slots / 2U]);
+
+	for (size_t i = 0U; i < slots; i++)
+	{
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page32->free_blocks, slots);
+
+	/*double free and addresses inside of a block are detected*/
+	heap.free(memory[0]);
+	heap.free(reinterpret_cast<void*>((size_t)memory[1] + 8U));
+	EXPECT_EQ(page32->free_blocks, slots);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapBigPageCoalescing)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 16U * 65536U));
+
+	rtsha_page* page_big = heap.get_big_memorypage();
+	EXPECT_TRUE(page_big != nullptr);
+	EXPECT_EQ(page_big->free_blocks, 1U);
+
+	const size_t count = 200U;
+	void* memory[count];
+	for (size_t i = 0U; i < count; i++)
+	{
+		memory[i] = heap.malloc(max((size_t)513U, (size_t)(std::rand() % 4000)));
+		EXPECT_TRUE(memory[i] != nullptr);
+	}
+
+	/*release all blocks in random order, all of them must be merged with both neighbours*/
+	for (size_t i = 0U; i < count; i++)
+	{
+		size_t j = i + (size_t)std::rand() % (count - i);
+		std::swap(memory[i], memory[j]);
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page_big->free_blocks, 1U);
+
+	WalkStatistics all;
+	EXPECT_TRUE(heap.walk(countBlocks, &all));
+	/*the free block and the last internal block of the big page*/
+	EXPECT_EQ(all.blocks, 2U);
+	EXPECT_EQ(all.free_blocks, 1U);
+
+	/*the whole page can be allocated again*/
+	void* big = heap.malloc(15U * 65536U);
+	EXPECT_TRUE(big != nullptr);
+	heap.free(big);
+	EXPECT_EQ(page_big->free_blocks, 1U);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapDeferredCoalescing)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+
+	rtsha_page* page_big = heap.get_big_memorypage();
+	EXPECT_TRUE(page_big != nullptr);
+	EXPECT_FALSE(heap.set_deferred_coalescing(heap.select_page(rtsha_page_size_type::PageType64, 20U), true));
+	EXPECT_TRUE(heap.set_deferred_coalescing(page_big, true));
+
+	/*fill the whole page*/
+	const size_t max_count = 256U;
+	void* memory[max_count];
+	size_t count = 0U;
+	while (count < max_count)
+	{
+		memory[count] = heap.malloc(2000U);
+		if (memory[count] == nullptr)
+		{
+			break;
+		}
+		memset(memory[count], (int)(count & 0xFF), 2000U);
+		count++;
+	}
+	EXPECT_GT(count, 4U);
+	EXPECT_LT(count, max_count);
+	size_t free_blocks = page_big->free_blocks;
+
+	/*the released blocks are neither merged nor inserted into the map*/
+	for (size_t i = 0U; i < count; i++)
+	{
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page_big->free_blocks, free_blocks);
+
+	WalkStatistics all;
+	EXPECT_TRUE(heap.walk(countBlocks, &all));
+	EXPECT_EQ(all.free_blocks, count + free_blocks);
+
+	/*a block of the same size is reused without merging*/
+	void* reused = heap.malloc(2000U);
+	EXPECT_EQ(reused, memory[count - 1U]);
+	heap.free(reused);
+
+	/*the request can not be satisfied by a single block, the deferred blocks are merged*/
+	void* merged = heap.malloc(4000U);
+	EXPECT_TRUE(merged != nullptr);
+	EXPECT_LT(page_big->free_blocks, count);
+	heap.free(merged);
+
+	/*bounded coalescing from an idle task*/
+	EXPECT_EQ(heap.coalesce(1U), 1U);
+	while (heap.coalesce(4U) > 0U)
+	{
+	}
+	EXPECT_EQ(heap.coalesce(4U), 0U);
+
+	/*all deferred blocks are merged back to one free block*/
+	EXPECT_EQ(page_big->free_blocks, 1U);
+	WalkStatistics coalesced;
+	EXPECT_TRUE(heap.walk(countBlocks, &coalesced));
+	EXPECT_EQ(coalesced.free_blocks, page_big->free_blocks);
+
+	/*immediate merging again*/
+	EXPECT_TRUE(heap.set_deferred_coalescing(page_big, false));
+	void* memory1 = heap.malloc(2000U);
+	EXPECT_TRUE(memory1 != nullptr);
+	free_blocks = page_big->free_blocks;
+	heap.free(memory1);
+	EXPECT_EQ(heap.coalesce(4U), 0U);
+	EXPECT_GE(page_big->free_blocks, free_blocks);
+
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapWalk)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType128, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+
+	void* memory1 = heap.malloc(30U);
+	void* memory2 = heap.malloc(30U);
+	void* memory3 = heap.malloc(80U);
+	void* memory4 = heap.malloc(2000U);
+	EXPECT_TRUE((memory1 != nullptr) && (memory2 != nullptr) && (memory3 != nullptr) && (memory4 != nullptr));
+	heap.free(memory2);
+
+	WalkStatistics all;
+	EXPECT_TRUE(heap.walk(countBlocks, &all));
+
+	/*2 blocks on page 64, 1 on page 128, allocated, free and last internal block on big page*/
+	EXPECT_EQ(all.blocks, 6U);
+	EXPECT_EQ(all.free_blocks, 2U);
+
+	/*the same result with a walk resumed after every block*/
+	WalkStatistics stepped;
+	rtsha_walk_cursor cursor;
+	size_t calls = 0U;
+	while (!heap.walk(cursor, 1U, countBlocks, &stepped))
+	{
+		calls++;
+	}
+	EXPECT_FALSE(cursor.inconsistent);
+	EXPECT_EQ(stepped.blocks, all.blocks);
+	EXPECT_EQ(stepped.free_blocks, all.free_blocks);
+	EXPECT_EQ(stepped.used_bytes, all.used_bytes);
+	EXPECT_GE(calls, all.blocks);
+
+	heap.free(memory1);
+	heap.free(memory3);
+	heap.free(memory4);
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapSnapshot)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeBig, 4U * 65536U));
+
+	void* memory1 = heap.malloc(30U);
+	void* memory2 = heap.malloc(2000U);
+	void* memory3 = heap.malloc(3000U);
+	heap.free(memory2);
+
+	/*buffer which is too small*/
+	uint8_t small_buffer[16U];
+	EXPECT_EQ(heap.snapshot(small_buffer, sizeof(small_buffer)), 0U);
+
+	std::vector<uint8_t> buffer(4096U);
+	size_t written = heap.snapshot(buffer.data(), buffer.size());
+	EXPECT_GT(written, sizeof(rtsha_snapshot_header));
+
+	rtsha_snapshot_header header;
+	::memcpy(&header, buffer.data(), sizeof(header));
+	EXPECT_EQ(header.magic, RTSHA_SNAPSHOT_MAGIC);
+	EXPECT_EQ(header.version, RTSHA_SNAPSHOT_VERSION);
+	EXPECT_EQ(header.address_size, sizeof(void*));
+	EXPECT_EQ(header.number_pages, 2U);
+	EXPECT_EQ(header.last_error, RTSHA_SnapshotBufferTooSmall);
+
+	/*parse the stream and check the block records of every page*/
+	size_t pos = sizeof(header);
+	size_t blocks[2U] = { 0U, 0U };
+	size_t free_blocks[2U] = { 0U, 0U };
+	for (uint32_t i = 0U; i < header.number_pages; i++)
+	{
+		rtsha_snapshot_page page;
+		::memcpy(&page, buffer.data() + pos, sizeof(page));
+		pos += sizeof(page);
+		EXPECT_EQ(page.index, i);
+
+		rtsha_snapshot_block block;
+		while (true)
+		{
+			ASSERT_LE(pos + sizeof(block), written);
+			::memcpy(&block, buffer.data() + pos, sizeof(block));
+			pos += sizeof(block);
+			if (block.offset == RTSHA_SNAPSHOT_END_OF_PAGE)
+			{
+				break;
+			}
+			blocks[i]++;
+			if (block.size & RTSHA_SNAPSHOT_BLOCK_FREE)
+			{
+				free_blocks[i]++;
+			}
+		}
+		rtsha_snapshot_page_summary summary;
+		::memcpy(&summary, buffer.data() + pos, sizeof(summary));
+		pos += sizeof(summary);
+		EXPECT_EQ(summary.number_blocks, blocks[i]);
+		EXPECT_EQ(summary.flags & RTSHA_SNAPSHOT_PAGE_INCONSISTENT, 0U);
+	}
+	EXPECT_EQ(pos, written);
+
+	/*one block on page 64, two allocated, one free and the last internal block on big page*/
+	EXPECT_EQ(blocks[0], 1U);
+	EXPECT_EQ(free_blocks[0], 0U);
+	EXPECT_EQ(blocks[1], 4U);
+	EXPECT_EQ(free_blocks[1], 2U);
+
+	heap.free(memory1);
+	heap.free(memory3);
+	free(heapMemory);
+}
+
+TEST(TestCaseClassHeap, TestHeapTLSFPage)
+{
+	size_t size = 0x1F4000;
+	void* heapMemory = malloc(size); //allocate 2MB for heap
+	EXPECT_TRUE(heapMemory != NULL);
+
+	Heap heap;
+	EXPECT_TRUE(heap.init(heapMemory, size));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageType64, 65536U));
+	EXPECT_TRUE(heap.add_page(NULL, rtsha_page_size_type::PageTypeTLSF, 16U * 65536U));
+
+	rtsha_page* page_tlsf = heap.select_page(rtsha_page_size_type::PageTypeTLSF, 1024U);
+	EXPECT_TRUE(page_tlsf != nullptr);
+	EXPECT_EQ(page_tlsf->free_blocks, 1U);
+
+	/*small blocks are still allocated on the fixed size page*/
+	void* small = heap.malloc(20U);
+	EXPECT_TRUE(small != nullptr);
+	EXPECT_NE(heap.get_block_page((address_t)small), page_tlsf);
+
+	const size_t count = 200U;
+	void* memory[count];
+	size_t sizes[count];
+	for (size_t i = 0U; i < count; i++)
+	{
+		sizes[i] = max((size_t)513U, (size_t)(std::rand() % 4000));
+		memory[i] = heap.malloc(sizes[i]);
+		EXPECT_TRUE(memory[i] != nullptr);
+		EXPECT_EQ(heap.get_block_page((address_t)memory[i]), page_tlsf);
+		memset(memory[i], (int)(i & 0xFF), sizes[i]);
+	}
+
+	/*free every second block, the free blocks can not be merged*/
+	for (size_t i = 0U; i < count; i += 2U)
+	{
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page_tlsf->free_blocks, (count / 2U) + 1U);
+
+	/*the released blocks are reused*/
+	for (size_t i = 0U; i < count; i += 2U)
+	{
+		memory[i] = heap.malloc(sizes[i]);
+		EXPECT_TRUE(memory[i] != nullptr);
+		memset(memory[i], (int)(i & 0xFF), sizes[i]);
+	}
+
+	for (size_t i = 0U; i < count; i++)
+	{
+		uint8_t* data = reinterpret_cast<uint8_t*>(memory[i]);
+		EXPECT_EQ(data[0], (uint8_t)(i & 0xFF));
+		EXPECT_EQ(data[sizes[i] - 1U], (uint8_t)(i & 0xFF));
+	}
+
+	/*release all blocks in random order, all of them must be merged back to one free block*/
+	for (size_t i = 0U; i < count; i++)
+	{
+		size_t j = i + (size_t)std::rand() % (count - i);
+		std::swap(memory[i], memory[j]);
+		heap.free(memory[i]);
+	}
+	EXPECT_EQ(page_tlsf->free_blocks, 1U);
+
+	WalkStatistics all;
+	EXPECT_TRUE(heap.walk(countBlocks, &all));
+	/*the small block, the free block and the last internal block of TLSF page*/
+	EXPECT_EQ(all.blocks, 3U);
+	EXPECT_EQ(all.free_blocks, 1U);
+
+	/*the whole page can be allocated again*/
+	void* big = heap.malloc(15U * 65536U);
+	EXPECT_TRUE(big != nullptr);
+	heap.free(big);
+
+	heap.free(small);
+	free(heapMemory);
+}
@@ -51,6 +51,21 @@ Here is documentation of C Interface RTSHA functions.
 */
 #define RTSHA_PAGE_TYPE_POWER_TWO		713U
 
+/**
+* \brief TLSF (Two Level Segregated Fit) Memory Page Type
+*/
+#define RTSHA_PAGE_TYPE_TLSF			813U
+
+/**
+* \brief Power Two Memory Page Type without block headers
+*/
+#define RTSHA_PAGE_TYPE_POWER_TWO_BITMAP	913U
+
+/**
+* \brief Fixed Memory Page Type without block headers. The block size is given by 'max_block_size'.
+*/
+#define RTSHA_PAGE_TYPE_FIXED_BITMAP		1013U
+
 /**
 * \brief This function creates heap. Only one heap is supported when using 'RTSHA C interface'
 *
@@ -71,7 +86,7 @@ bool  rtsha_create_heap(void* start, size_t size);
 *
 * \param size The size of heap memory.
 *
-* \param page_type The type of the memory page.
+* \param page_type The type of the memory page. For a 'Small Fixed Memory Page' any block size which is a multiple of the pointer size and not larger than 4096 bytes can be used as page type.
 *
 * \param max_objects The maximum number of blocks that can exist on the page. This parameter is used exclusively for 'Big Memory Page' and 'Power of Two Memory Page'. For 'Small Fixed Memory Page', this value can be set to 0. 
 *
@@ -182,6 +197,33 @@ void* rtsha_memcpy(void* _Dst, void const* _Src, size_t _Size);
 */
 void* rtsha_memset(void* _Dst, int _Val, size_t _Size);
 
+/**
+* \brief This function writes a compact binary snapshot of the heap into the caller-provided buffer.
+*
+* The snapshot contains all page descriptors, block headers and a summary of the free structures of every page.
+* It can be analyzed offline with the 'rtsha_analyze' tool.
+*
+* \param buffer Destination buffer.
+*
+* \param size Size of the destination buffer in bytes.
+*
+* \return Returns the number of written bytes or 0 when the buffer is too small.
+*
+*/
+size_t rtsha_snapshot(void* buffer, size_t size);
+
+/**
+* \brief This function merges blocks released in deferred mode with their free neighbours.
+*
+* The function is intended to be called from an idle task. The amount of work is limited by the budget.
+*
+* \param budget Maximum number of deferred blocks to merge.
+*
+* \return Returns the number of merged blocks.
+*
+*/
+size_t rtsha_coalesce(size_t budget);
+
  /*! @} */
 
 
@@ -223,6 +265,9 @@ void* rtsha_memset(void* _Dst, int _Val, size_t _Size);
 /** @brief Error code indicating an invalid number of free blocks. */
 #define RTSHA_InvalidNumberOfFreeBlocks		(258U)
 
+/** @brief Error code indicating that the buffer is too small for the heap snapshot. */
+#define RTSHA_SnapshotBufferTooSmall		(1024U)
+
 /** @} */ // end of RTSHA_ERRORS group
 
 
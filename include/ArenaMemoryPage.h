@@ -0,0 +1,117 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+
+
+namespace rtsha
+{
+	using namespace std;
+
+	/**
+	* @class ArenaMemoryPage
+	* @brief This class provides memory handling functions for the 'Arena Memory Page'
+	*
+	* An allocation only advances the current position of the page. The blocks have no header and are not released one by one,
+	* the whole page is released by 'reset' and the blocks allocated after a marker are released by 'rewind'.
+	*/
+	class ArenaMemoryPage : public MemoryPage
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		ArenaMemoryPage() = delete;
+
+		/**
+		* @brief Constructor that initializes the ArenaMemoryPage with a given page.
+		* @param page The rtsha_page structure to initialize the ArenaMemoryPage with.
+		*/
+		explicit ArenaMemoryPage(rtsha_page* page) : MemoryPage(page)
+		{
+		}
+
+		/// @brief Virtual destructor for the ArenaMemoryPage.
+		virtual ~ArenaMemoryPage()
+		{
+		}
+
+		/*! \fn allocate_block(size_t size)
+		* \brief Allocates a block of memory aligned to RTSHA_ALIGMENT.
+		*
+		* \param size The requested number of bytes.
+		*
+		* \return On success, a pointer to the memory block allocated by the function.
+		*/
+		virtual void* allocate_block(const size_t& size) noexcept final;
+
+		/**
+		* @brief Allocates a block of memory with the given alignment.
+		*
+		* @param size The requested number of bytes.
+		* @param alignment The alignment of the block, a power of two.
+		* @return On success, a pointer to the memory block allocated by the function.
+		*/
+		void* allocate_aligned(size_t size, size_t alignment) noexcept;
+
+		/**
+		* @brief The blocks of the page are not released one by one, the function does nothing.
+		* @param block The memory block.
+		*/
+		virtual void free_block(MemoryBlock& block) noexcept final;
+
+		/**
+		* @brief Returns the current position of the page, which can be passed to 'rewind'.
+		*/
+		address_t marker() noexcept;
+
+		/**
+		* @brief Releases all blocks allocated after the marker was taken.
+		*
+		* @param marker A value returned by 'marker'.
+		* @return False if the marker is not between the start and the current position of the page.
+		*/
+		bool rewind(address_t marker) noexcept;
+
+		/**
+		* @brief Releases all blocks of the page.
+		*/
+		void reset() noexcept;
+
+		/**
+		* @brief Visits the page. The allocated area is reported as one used block and the rest of the page as one free block.
+		*
+		* @param cursor Walk cursor. The position is updated to the next block, or set to 0 when the page has been walked.
+		* @param max_steps Maximum number of blocks to visit.
+		* @param callback Function called for every visited block.
+		* @param context User context passed to the callback.
+		* @return The number of visited blocks.
+		*/
+		size_t walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept;
+	};
+}
@@ -41,6 +41,10 @@ namespace rtsha
 	*Similar to the 'Power Two Memory Page', this algorithm employs the 'Best Fit' algorithm, in conjunction with a 'Red-Black' balanced tree,
 	*which offers worst-case guarantees for insertion, deletion, and search times. 
 	*It promptly merges or coalesces memory blocks larger than 'MIN_BLOCK_SIZE_FOR_SPLIT' bytes after they are released.
+	*
+	*In deferred mode the released blocks are only pushed to a list of deferred blocks, so 'free' takes constant time.
+	*The blocks of the list are reused for requests of the same size and merged when an allocation can not be satisfied
+	*or when 'coalesce' is called.
 	*/
 	class BigMemoryPage : public MemoryPage
 	{
@@ -77,12 +81,46 @@ namespace rtsha
 		*/
 		virtual void free_block(MemoryBlock& block) noexcept final;
 
+		/**
+		* @brief Merges blocks released in deferred mode with their free neighbours.
+		* @param budget Maximum number of deferred blocks to merge.
+		* @return The number of merged deferred blocks.
+		*/
+		size_t coalesce(size_t budget) noexcept;
+
+		/**
+		* @brief Switches the deferred coalescing mode. When it is disabled, all deferred blocks are merged.
+		* The switch and the merge are done under the page lock.
+		* @param enable True to enable the deferred mode.
+		*/
+		void set_deferred(bool enable) noexcept;
+
 		/**
 		* @brief Creates the initial first two free blocks within the page.
 		*/
 		void createInitialFreeBlocks() noexcept;
 
 	protected:
+
+		/**
+		* @brief Allocates the best fitting block from the map of free blocks. The page must be locked.
+		* @param a_size The size of the block including the block header data.
+		* @return On success, a pointer to the allocated memory, otherwise null pointer.
+		*/
+		void* allocateFromMap(size_t a_size) noexcept;
+
+		/**
+		* @brief Merges at most 'budget' deferred blocks and inserts them into the map. The page must be locked.
+		* @param budget Maximum number of deferred blocks to merge.
+		* @return The number of merged deferred blocks.
+		*/
+		size_t coalesceDeferred(size_t budget) noexcept;
+
+		/**
+		* @brief Merges a free block with both free neighbours and inserts the result into the map once. The page must be locked.
+		* @param block The released block.
+		*/
+		void releaseBlock(MemoryBlock& block) noexcept;
 		
 		/**
 		* @brief Splits a memory block based on the specified size.
@@ -92,15 +130,21 @@ namespace rtsha
 		void splitBlock(MemoryBlock& block, size_t size)  noexcept;
 
 		/**
-		* @brief Merges the specified block with its left neighbor.
-		* @param block The block to be merged with its left neighbor.
+		* @brief Removes the free left neighbor from the map and merges it with the specified block.
+		* @param block The block to be merged with its left neighbor. It refers to the merged block afterwards.
 		*/
 		void mergeLeft(MemoryBlock& block) noexcept;
 
 		/**
-		* @brief Merges the specified block with its right neighbor.
+		* @brief Removes the free right neighbor from the map and merges it with the specified block.
 		* @param block The block to be merged with its right neighbor.
 		*/
 		void mergeRight(MemoryBlock& block)  noexcept;
+
+		/**
+		* @brief Removes a free block from the map or from the list of deferred blocks.
+		* @param block The free block.
+		*/
+		void removeFreeBlock(MemoryBlock& block) noexcept;
 	};
 }
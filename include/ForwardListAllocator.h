@@ -27,7 +27,9 @@ SOFTWARE.
 
 #pragma once
 #include "MemoryPage.h"
+#include "MemoryBlock.h"
 #include <cstdlib>
+#include <limits>
 
 #ifdef _RTSHA_DIAGNOSTIK
 #include <iostream>
@@ -72,8 +74,8 @@ namespace rtsha
         */
         template<class U>
         constexpr ForwardListAllocator(const ForwardListAllocator <U>& rhs) noexcept
+            : _page(rhs._page)
         {
-            this->_page             = rhs._page;
         }
 
         /**
@@ -96,7 +98,9 @@ namespace rtsha
                 return nullptr;
             }                        
 
-            if (auto p = static_cast<T*>(_page.allocate_block(n * sizeof(T)) ))
+            /*the page gets the size of the whole block*/
+            const size_t size = rtsha_align(n * sizeof(T) + sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE, RTSHA_ALIGMENT);
+            if (auto p = static_cast<T*>(_page.allocate_block(size) ))
             {
                 return p;
             }
@@ -104,16 +108,20 @@ namespace rtsha
         }
 
         /**
-        * @brief Deallocates memory. In this custom allocator, the deallocation is a no-op.
+        * @brief Deallocates memory. The block is returned to the page, so it is reused by the following allocations.
         *
-        * It is called from 'forward_list' every time when 'pop' method is called
-        * 
+        * It is called from 'forward_list' every time when 'pop' method is called.
+        * A block which is not valid or already free is ignored.
+        *
+        * @param p Pointer to the memory to deallocate.
+        * @param n Number of objects, always 1 for 'forward_list'. Not used, the size is taken from the block header.
         */
         rtsha_attr_inline void deallocate(T* p, std::size_t n) noexcept
         {
+            (void)n;
             if (p != nullptr)
             {
-                size_t address = (size_t)ptr;
+                size_t address = (size_t)p;
                 address -= sizeof(rtsha_block); /*skip size and pointer to prev*/
                 MemoryBlock block(reinterpret_cast<rtsha_block*>(address));
                 if (block.isValid() && !block.isFree())
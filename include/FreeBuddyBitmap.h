@@ -0,0 +1,242 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+#include "internal.h"
+
+namespace internal
+{
+	using namespace std;
+	using namespace rtsha;
+
+	/// @brief The largest block order of a 'Power Two Bitmap Memory Page'. The order bitmap is 32 bits wide.
+	constexpr size_t BUDDY_MAX_ORDER = 31U;
+
+	/**
+	* @struct rtsha_buddy_links
+	* @brief Links of a free block in the list of its order.
+	*
+	* The blocks of a 'Power Two Bitmap Memory Page' have no header, the links are stored at the beginning of the free block.
+	*/
+	struct rtsha_buddy_links
+	{
+		rtsha_buddy_links*	next_free;	///< Next free block of the same order.
+		rtsha_buddy_links*	prev_free;	///< Previous free block of the same order.
+	};
+
+	/// @brief The smallest block order: a free block must hold the list links.
+	constexpr size_t BUDDY_MIN_ORDER = (sizeof(rtsha_buddy_links) == 16U) ? 4U : 3U;
+
+	/**
+	* @class FreeBuddyBitmap
+	* @brief Out-of-band metadata of a 'Power Two Bitmap Memory Page'.
+	*
+	* The data area of the page is divided into top blocks of the maximal order. Every top block is a binary buddy tree.
+	* Two bitmaps stored at the page head hold one bit per tree node: 'free' marks a free block of the node order
+	* and 'split' marks a node which has been divided into two buddies. The order of an allocated block is found
+	* from the 'split' bits, so the blocks do not need any header. Free blocks of every order are kept in
+	* doubly linked lists and a bitmap marks the non empty orders.
+	*/
+	class alignas(sizeof(size_t)) FreeBuddyBitmap
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		FreeBuddyBitmap() = delete;
+
+		/**
+		* @brief Constructs the index. All bits and lists are cleared.
+		*
+		* @param page The rtsha_page that this index will manage.
+		* @param min_order The order of the smallest block.
+		* @param max_order The order of the top blocks.
+		* @param top_blocks The number of top blocks.
+		* @param bitmap Storage of the bitmaps, 'bitmap_words' words.
+		* @param base Address of the first top block.
+		*/
+		FreeBuddyBitmap(rtsha_page* page, size_t min_order, size_t max_order, size_t top_blocks, size_t* bitmap, address_t base) noexcept;
+
+		/// @brief Destructor for the FreeBuddyBitmap.
+		~FreeBuddyBitmap() noexcept
+		{
+		}
+
+		/**
+		* @brief Calculates the number of words needed for both bitmaps.
+		*
+		* @param min_order The order of the smallest block.
+		* @param max_order The order of the top blocks.
+		* @param top_blocks The number of top blocks.
+		* @return The number of size_t words.
+		*/
+		rtsha_attr_inline static size_t bitmap_words(size_t min_order, size_t max_order, size_t top_blocks) noexcept
+		{
+			const size_t bits = top_blocks << (max_order - min_order + 1U);
+			return 2U * ((bits + (8U * sizeof(size_t)) - 1U) / (8U * sizeof(size_t)));
+		}
+
+		/**
+		* @brief Inserts a free block into the list of its order and marks it as free.
+		*
+		* @param block Address of the block.
+		* @param order Order of the block.
+		*/
+		void insert(address_t block, size_t order) noexcept;
+
+		/**
+		* @brief Removes a free block from the list of its order and clears its 'free' bit.
+		*
+		* @param block Address of the block.
+		* @param order Order of the block.
+		*/
+		void remove(address_t block, size_t order) noexcept;
+
+		/**
+		* @brief Removes a free block of the smallest order which is not smaller than the requested one.
+		*
+		* @param order The requested order. The order of the returned block is written back.
+		* @return Address of the block or 0 if there is no such block.
+		*/
+		address_t pop(size_t& order) noexcept;
+
+		/**
+		* @brief Finds the order of an allocated or free block from the 'split' bits.
+		*
+		* @param block Address of the block.
+		* @return The order of the block or 0 if the address is not the start of a block.
+		*/
+		size_t order_of(address_t block) const noexcept;
+
+		/**
+		* @brief Checks if the node of the given order at the address is a free block.
+		*/
+		rtsha_attr_inline bool is_free(address_t block, size_t order) const noexcept
+		{
+			return test_bit(_free_bits, bit_index(block, order));
+		}
+
+		/**
+		* @brief Marks the node of the given order at the address as split or as whole.
+		*/
+		rtsha_attr_inline void set_split(address_t block, size_t order, bool split) noexcept
+		{
+			if (split)
+			{
+				set_bit(_split_bits, bit_index(block, order));
+			}
+			else
+			{
+				clear_bit(_split_bits, bit_index(block, order));
+			}
+		}
+
+		/**
+		* @brief Checks if the address belongs to the data area of the page.
+		*/
+		rtsha_attr_inline bool contains(address_t block) const noexcept
+		{
+			return (block >= _base) && (block < _end);
+		}
+
+		/** @brief Returns the address of the first top block. */
+		rtsha_attr_inline address_t base() const noexcept
+		{
+			return _base;
+		}
+
+		/** @brief Returns the end of the data area. */
+		rtsha_attr_inline address_t end() const noexcept
+		{
+			return _end;
+		}
+
+		/** @brief Returns the order of the smallest block. */
+		rtsha_attr_inline size_t min_order() const noexcept
+		{
+			return _min_order;
+		}
+
+		/** @brief Returns the order of the top blocks. */
+		rtsha_attr_inline size_t max_order() const noexcept
+		{
+			return _max_order;
+		}
+
+		/**
+		* @brief Retrieves the number of the free blocks in the index.
+		*
+		* @return The number of the free blocks.
+		*/
+		rtsha_attr_inline size_t size() const noexcept
+		{
+			return _count;
+		}
+
+	private:
+
+		/** @brief Returns the bit of the node of the given order containing the address. */
+		rtsha_attr_inline size_t bit_index(address_t block, size_t order) const noexcept
+		{
+			const size_t offset = block - _base;
+			const size_t top = offset >> _max_order;
+			const size_t local = offset & ((static_cast<size_t>(1U) << _max_order) - 1U);
+			/*heap order of the tree nodes: the top block is node 1, the children of node i are 2i and 2i+1*/
+			const size_t node = (static_cast<size_t>(1U) << (_max_order - order)) + (local >> order);
+			return (top << (_max_order - _min_order + 1U)) + node;
+		}
+
+		rtsha_attr_inline static bool test_bit(const size_t* bits, size_t index) noexcept
+		{
+			return (0U != (bits[index / (8U * sizeof(size_t))] & (static_cast<size_t>(1U) << (index % (8U * sizeof(size_t))))));
+		}
+
+		rtsha_attr_inline static void set_bit(size_t* bits, size_t index) noexcept
+		{
+			bits[index / (8U * sizeof(size_t))] |= (static_cast<size_t>(1U) << (index % (8U * sizeof(size_t))));
+		}
+
+		rtsha_attr_inline static void clear_bit(size_t* bits, size_t index) noexcept
+		{
+			bits[index / (8U * sizeof(size_t))] &= ~(static_cast<size_t>(1U) << (index % (8U * sizeof(size_t))));
+		}
+
+	private:
+		rtsha_page*				_page;								///< The memory page being managed by the index.
+		size_t					_min_order;							///< Order of the smallest block.
+		size_t					_max_order;							///< Order of the top blocks.
+		address_t				_base;								///< Address of the first top block.
+		address_t				_end;								///< End of the data area.
+		size_t*					_free_bits;							///< One bit per tree node, set for a free block.
+		size_t*					_split_bits;						///< One bit per tree node, set for a split node.
+		size_t					_count = 0U;						///< Number of the free blocks.
+		uint32_t				_order_map = 0U;					///< Non empty lists.
+		rtsha_buddy_links*		_lists[BUDDY_MAX_ORDER + 1U];		///< Heads of the lists per order.
+	};
+}
@@ -25,30 +25,43 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 ******************************************************************************/
 
+
 #pragma once
 #include <stdint.h>
-#include "MemoryBlock.h"
-#include "InternMapAllocator.h"
+#include "MemoryPage.h"
 #include "internal.h"
-#include "map"
 
 namespace internal
 {
 	using namespace std;
 	using namespace rtsha;
 
-	using mmap_allocator = InternMapAllocator<std::pair<const uint64_t, size_t>>;
-	
-	using mmap = std::multimap<const uint64_t, size_t, std::less<const uint64_t>, internal::InternMapAllocator<std::pair<const uint64_t, size_t>>>;
-	
+	/**
+	* @struct rtsha_free_map_node
+	* @brief Node of the free block tree.
+	*
+	* The node is stored in the data area of the free block, directly after the block header.
+	*/
+	struct rtsha_free_map_node
+	{
+		rtsha_free_map_node*	left;			///< Left child.
+		rtsha_free_map_node*	right;			///< Right child.
+		uintptr_t				parent_color;	///< Parent node. Bit 0 is set when the node is red, bit 1 when the node is linked in the map.
+		rtsha_free_map_node*	next_dup;		///< Next free block of the same size.
+		rtsha_free_map_node*	prev_dup;		///< Previous free block of the same size. Null for the tree node.
+	};
+
+	/// @brief The minimal size of a free block on a 'Big Memory Page': block header, map node and the size copy at the end of the block.
+	constexpr size_t FREE_MAP_MIN_BLOCK_SIZE = ((sizeof(rtsha_block) + sizeof(rtsha_free_map_node) + RTSHA_BLOCK_FOOTER_SIZE + RTSHA_ALIGMENT - 1U) / RTSHA_ALIGMENT) * RTSHA_ALIGMENT;
+
 	/**
 	* @class FreeMap
-	* @brief A memory-efficient multimap implementation aligned to the size of size_t.
+	* @brief An intrusive red-black tree of free blocks ordered by the block size.
 	*
-	* The FreeMap class is designed to manage key-value pairs in memory.
-	* It offers functionalities like insertion, deletion, and lookup of key-value pairs.
-	* Internally, it employs a custom allocator and map structure to handle the memory.
-	* Custom allocator uses a small part of memory page as 'SmallFixedMemoryPage'
+	* The FreeMap class is used by 'Big Memory Page' to find the best fitting free block.
+	* The nodes live in the free blocks themselves, so inserting and deleting a block does not allocate any memory.
+	* The tree holds one node per block size. Further free blocks of the same size are kept in a doubly linked list
+	* hanging off the tree node, so a block is removed in constant time regardless of the number of blocks with the same size.
 	*/
 	class alignas(sizeof(size_t)) FreeMap
 	{
@@ -58,7 +71,7 @@ namespace internal
 		FreeMap() = delete;
 
 		/**
-		* @brief Constructs a FreeMap with the provided memory page.
+		* @brief Constructs an empty FreeMap for the provided memory page.
 		*
 		* @param page The rtsha_page that this FreeMap will manage.
 		*/
@@ -70,113 +83,207 @@ namespace internal
 		}
 
 		/**
-		* @brief Inserts a key-value pair into the multimap.
+		* @brief Inserts a free block into the tree.
 		*
-		* @param key The key for the insertion. (The size of block is used as a key.)
-		* @param block The associated value for the key. (Address of the block in memory.)
+		* @param key The size of the block.
+		* @param block Address of the block in memory.
 		*/
-		rtsha_attr_inline void insert(const uint64_t key, size_t block) noexcept
-		{
-			if ((_ptrMap != nullptr))
-			{
-				_ptrMap->insert(std::pair<const uint64_t, size_t>(key, block));
-			}
-		}
+		void insert(const uint64_t key, size_t block) noexcept;
 
 		/**
-		* @brief Deletes a key-value pair from the map based on the given key.
+		* @brief Deletes a free block from the map.
 		*
-		* @param key The key of the key-value pair to be deleted.
-		* @param block The associated value for the key.
+		* The block is found by its identity (the node stored in the block), no search is needed.
+		* The data area of the block is read as a map node, so the block must be free.
+		*
+		* @param block Address of the block in memory.
 		* @return True if the deletion was successful, otherwise false.
 		*/
-		rtsha_attr_inline bool del(const uint64_t key, size_t block) noexcept
+		bool del(size_t block) noexcept;
+
+		/**
+		* @brief Finds the smallest free block which is not smaller than the given size.
+		*
+		* @param key The requested size.
+		* @return Address of the block or 0 if there is no such block.
+		*/
+		size_t find(const uint64_t key) noexcept;
+
+		/**
+		* @brief Checks if a given block is in the map.
+		*
+		* The data area of the block is read as a map node, so the block must be free.
+		*
+		* @param block Address of the block in memory.
+		* @return True if the block is in the map, otherwise false.
+		*/
+		bool exists(size_t block) noexcept;
+
+		/**
+		* @brief Retrieves the number of the free blocks in the map.
+		*
+		* @return The size of the map.
+		*/
+		rtsha_attr_inline size_t size() const noexcept
 		{
-			if ((_ptrMap != nullptr))
-			{
-				mmap::iterator it = _ptrMap->find(key);
-				while(it != _ptrMap->end())
-				{
-					if ((it->first == key) && (it->second == block))
-					{
-						it = _ptrMap->erase(it);
-						return true;
-					}
-					it++;
-				}
-			}
-			return false;
+			return _count;
 		}
 
 		/**
-		* @brief Finds the value associated with a given key.
+		* @brief Pushes a released block to the list of deferred blocks.
+		*
+		* The deferred block is free, but it is neither merged with its neighbours nor inserted into the tree.
+		*
+		* @param block Address of the block in memory.
+		*/
+		void defer(size_t block) noexcept;
+
+		/**
+		* @brief Removes a block from the list of deferred blocks.
+		*
+		* The data area of the block is read as a map node, so the block must be free.
+		*
+		* @param block Address of the block in memory.
+		* @return True if the block was in the list, otherwise false.
+		*/
+		bool undefer(size_t block) noexcept;
+
+		/**
+		* @brief Takes a deferred block which can be reused without splitting.
+		*
+		* At most 'max_scan' blocks from the head of the list are checked.
+		* A block fits if it is not smaller than the requested size and the rest is smaller than 'MIN_BLOCK_SIZE_FOR_SPLIT'.
+		*
+		* @param key The requested size.
+		* @param max_scan Maximum number of blocks to check.
+		* @return Address of the block removed from the list or 0 if there is no such block.
+		*/
+		size_t take_deferred(const uint64_t key, size_t max_scan) noexcept;
+
+		/**
+		* @brief Removes the first block from the list of deferred blocks.
 		*
-		* @param key The key to be looked up.
-		* @return The value associated with the key.
+		* @return Address of the block or 0 if the list is empty.
 		*/
-		rtsha_attr_inline size_t find(const uint64_t key) noexcept
+		size_t pop_deferred() noexcept;
+
+		/**
+		* @brief Retrieves the number of the deferred blocks.
+		*
+		* @return The number of blocks in the list of deferred blocks.
+		*/
+		rtsha_attr_inline size_t deferred_size() const noexcept
 		{
-			if ((_ptrMap != nullptr))
-			{
-				mmap::iterator it = _ptrMap->lower_bound(key);
-				if (it != _ptrMap->end())
-				{
-					return it->second;
-				}
-			}
-			return 0U;
+			return _deferred_count;
 		}
 
-
 		/**
-		* @brief Checks if a given key-value pair exists in the map.
+		* @brief Enables or disables deferred coalescing of the released blocks.
 		*
-		* @param key The key to be checked.
-		* @param block The associated value for the key.
-		* @return True if the key-value pair exists, otherwise false.
+		* @param enable True to defer the coalescing.
 		*/
-		rtsha_attr_inline bool exists(const uint64_t key, size_t block)  noexcept
+		rtsha_attr_inline void set_deferred(bool enable) noexcept
 		{
-			if ((_ptrMap != nullptr))
-			{
-				mmap::iterator it = _ptrMap->find(key);
-				if (it != _ptrMap->end())
-				{
-					if ((it->first == key) && (it->second == block))
-					{
-						return true;
-					}
-				}
-			}
-			return false;
+			_deferred_mode = enable;
 		}
 
 		/**
-		* @brief Retrieves the number of key-value pairs in the map.
+		* @brief Checks if the released blocks are coalesced lazily.
 		*
-		* @return The size of the map.
+		* @return True if deferred coalescing is enabled.
 		*/
-		rtsha_attr_inline size_t size() const noexcept
+		rtsha_attr_inline bool is_deferred() const noexcept
+		{
+			return _deferred_mode;
+		}
+
+	private:
+
+		/** @brief Returns the tree node stored in the free block. */
+		rtsha_attr_inline static rtsha_free_map_node* node_of(size_t block) noexcept
+		{
+			return reinterpret_cast<rtsha_free_map_node*>(block + sizeof(rtsha_block));
+		}
+
+		/** @brief Returns the address of the free block owning the node. */
+		rtsha_attr_inline static size_t block_of(const rtsha_free_map_node* node) noexcept
+		{
+			return reinterpret_cast<size_t>(node) - sizeof(rtsha_block);
+		}
+
+		/** @brief Returns the key of the node - the size of the free block. */
+		rtsha_attr_inline static uint64_t key_of(const rtsha_free_map_node* node) noexcept
 		{
-			if ((_ptrMap != nullptr))
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(block_of(node)));
+			return static_cast<uint64_t>(block.getSize());
+		}
+
+		/** @brief Returns the parent of the node. */
+		rtsha_attr_inline static rtsha_free_map_node* parent(const rtsha_free_map_node* node) noexcept
+		{
+			return reinterpret_cast<rtsha_free_map_node*>(node->parent_color & ~static_cast<uintptr_t>(3U));
+		}
+
+		/** @brief Sets the parent of the node and keeps its color. */
+		rtsha_attr_inline static void set_parent(rtsha_free_map_node* node, rtsha_free_map_node* parent) noexcept
+		{
+			node->parent_color = reinterpret_cast<uintptr_t>(parent) | (node->parent_color & 3U);
+		}
+
+		/** @brief Checks if the node is red. Null leaves are black. */
+		rtsha_attr_inline static bool is_red(const rtsha_free_map_node* node) noexcept
+		{
+			return (node != nullptr) && ((node->parent_color & 1U) != 0U);
+		}
+
+		/** @brief Colors the node red. */
+		rtsha_attr_inline static void set_red(rtsha_free_map_node* node) noexcept
+		{
+			node->parent_color |= 1U;
+		}
+
+		/** @brief Colors the node black. */
+		rtsha_attr_inline static void set_black(rtsha_free_map_node* node) noexcept
+		{
+			if (node != nullptr)
 			{
-				return _ptrMap->size();
+				node->parent_color &= ~static_cast<uintptr_t>(1U);
 			}
-			return 0U;
 		}
 
+		/** @brief Checks if the node is linked in the tree or in a list of blocks of the same size. */
+		bool is_linked(const rtsha_free_map_node* node) const noexcept;
 
-				
-	private:
-		rtsha_page*			_page;				///< The memory page being managed by the free map.
-		mmap_allocator*		_mallocator;		///< Internal map allocator for managing memory key-value pairs.
-		mmap*				_ptrMap;			///< Pointer to the map structure used internally.
-		
+		/** @brief Unlinks the node from the list of deferred blocks. */
+		void unlink_deferred(rtsha_free_map_node* node) noexcept;
+
+		/** @brief Rotates the subtree of the node to the left. */
+		void rotate_left(rtsha_free_map_node* node) noexcept;
+
+		/** @brief Rotates the subtree of the node to the right. */
+		void rotate_right(rtsha_free_map_node* node) noexcept;
+
+		/** @brief Replaces the node with another node (or null) in its parent. */
+		void replace(rtsha_free_map_node* node, rtsha_free_map_node* with) noexcept;
+
+		/** @brief Restores the red-black properties after an insertion. */
+		void insert_fixup(rtsha_free_map_node* node) noexcept;
+
+		/** @brief Removes the node from the tree. */
+		void erase(rtsha_free_map_node* node) noexcept;
+
+		/** @brief Restores the red-black properties after a removal. */
+		void erase_fixup(rtsha_free_map_node* node, rtsha_free_map_node* parent) noexcept;
 
 	private:
+		static constexpr uintptr_t	LINKED = 2U;	///< Bit 1 of 'parent_color': the node is linked in the map.
+		static constexpr uintptr_t	DEFERRED = 4U;	///< Value of 'parent_color' of a node in the list of deferred blocks.
 
-		/// @brief Reserved storage for an object that will be created using 'placement new' on the stack.
-		PREALLOC_MEMORY <mmap_allocator>		_storage_allocator = 0U;
-		PREALLOC_MEMORY<mmap>					_storage_map = 0U;
+		rtsha_page*				_page;						///< The memory page being managed by the free map.
+		rtsha_free_map_node*	_root = nullptr;			///< Root of the tree.
+		size_t					_count = 0U;				///< Number of the free blocks in the tree.
+		rtsha_free_map_node*	_deferred = nullptr;		///< Head of the list of deferred blocks, linked through 'next_dup' and 'prev_dup'.
+		size_t					_deferred_count = 0U;		///< Number of the deferred blocks.
+		bool					_deferred_mode = false;		///< True if the released blocks are coalesced lazily.
 	};
 }
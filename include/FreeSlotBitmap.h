@@ -0,0 +1,167 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+#include "internal.h"
+
+namespace internal
+{
+	using namespace std;
+	using namespace rtsha;
+
+	/// @brief Number of bits in a bitmap word.
+	constexpr size_t SLOT_BITS_PER_WORD = 8U * sizeof(size_t);
+
+	/**
+	* @class FreeSlotBitmap
+	* @brief Out-of-band metadata of a 'Fixed Bitmap Memory Page'.
+	*
+	* The data area of the page is divided into slots of the same size. The index of a slot is
+	* '(address - base) / block_size'. The slot bitmap stored at the page head holds one bit per slot,
+	* set for a free slot. A second bitmap holds one bit per word of the slot bitmap, set when the word
+	* contains a free slot, so a free slot is found with two 'count trailing zeros' instructions
+	* per 'SLOT_BITS_PER_WORD * SLOT_BITS_PER_WORD' slots.
+	*/
+	class alignas(sizeof(size_t)) FreeSlotBitmap
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		FreeSlotBitmap() = delete;
+
+		/**
+		* @brief Constructs the index. All slots are marked as free.
+		*
+		* @param page The rtsha_page that this index will manage.
+		* @param block_size The size of every slot.
+		* @param slots The number of slots.
+		* @param bitmap Storage of the bitmaps, 'bitmap_words' words.
+		* @param base Address of the first slot.
+		*/
+		FreeSlotBitmap(rtsha_page* page, size_t block_size, size_t slots, size_t* bitmap, address_t base) noexcept;
+
+		/// @brief Destructor for the FreeSlotBitmap.
+		~FreeSlotBitmap() noexcept
+		{
+		}
+
+		/**
+		* @brief Calculates the number of words needed for both bitmaps.
+		*
+		* @param slots The number of slots.
+		* @return The number of size_t words.
+		*/
+		rtsha_attr_inline static size_t bitmap_words(size_t slots) noexcept
+		{
+			const size_t words = (slots + SLOT_BITS_PER_WORD - 1U) / SLOT_BITS_PER_WORD;
+			return words + ((words + SLOT_BITS_PER_WORD - 1U) / SLOT_BITS_PER_WORD);
+		}
+
+		/**
+		* @brief Takes the free slot with the lowest address.
+		*
+		* @return Address of the slot or 0 if all slots are in use.
+		*/
+		address_t pop() noexcept;
+
+		/**
+		* @brief Marks an allocated slot as free.
+		*
+		* @param block Address of the slot.
+		* @return False if the address is not the start of a slot or the slot is already free.
+		*/
+		bool release(address_t block) noexcept;
+
+		/**
+		* @brief Checks if the address is the start of an allocated slot.
+		*/
+		bool is_allocated(address_t block) const noexcept;
+
+		/**
+		* @brief Checks if the slot with the given index is free.
+		*/
+		rtsha_attr_inline bool is_free(size_t slot) const noexcept
+		{
+			return (0U != (_free_bits[slot / SLOT_BITS_PER_WORD] & (static_cast<size_t>(1U) << (slot % SLOT_BITS_PER_WORD))));
+		}
+
+		/**
+		* @brief Checks if the address belongs to the data area of the page.
+		*/
+		rtsha_attr_inline bool contains(address_t block) const noexcept
+		{
+			return (block >= _base) && (block < _end);
+		}
+
+		/** @brief Returns the address of the first slot. */
+		rtsha_attr_inline address_t base() const noexcept
+		{
+			return _base;
+		}
+
+		/** @brief Returns the end of the data area. */
+		rtsha_attr_inline address_t end() const noexcept
+		{
+			return _end;
+		}
+
+		/** @brief Returns the size of every slot. */
+		rtsha_attr_inline size_t block_size() const noexcept
+		{
+			return _block_size;
+		}
+
+		/** @brief Returns the number of slots. */
+		rtsha_attr_inline size_t slots() const noexcept
+		{
+			return _slots;
+		}
+
+		/**
+		* @brief Retrieves the number of the free slots.
+		*
+		* @return The number of the free slots.
+		*/
+		rtsha_attr_inline size_t size() const noexcept
+		{
+			return _count;
+		}
+
+	private:
+		rtsha_page*		_page;			///< The memory page being managed by the index.
+		size_t			_block_size;	///< Size of every slot.
+		size_t			_slots;			///< Number of slots.
+		size_t			_words;			///< Number of words of the slot bitmap.
+		address_t		_base;			///< Address of the first slot.
+		address_t		_end;			///< End of the data area.
+		size_t*			_free_bits;		///< One bit per slot, set for a free slot.
+		size_t*			_word_bits;		///< One bit per word of the slot bitmap, set when the word contains a free slot.
+		size_t			_count = 0U;	///< Number of the free slots.
+	};
+}
@@ -0,0 +1,187 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+#include "internal.h"
+
+namespace internal
+{
+	using namespace std;
+	using namespace rtsha;
+
+	/// @brief log2 of the number of second level lists per first level class.
+	constexpr uint32_t TLSF_SL_INDEX_COUNT_LOG2 = 4U;
+
+	/// @brief Number of second level lists per first level class.
+	constexpr uint32_t TLSF_SL_INDEX_COUNT = (1U << TLSF_SL_INDEX_COUNT_LOG2);
+
+	/// @brief log2 of the block size granularity.
+	constexpr uint32_t TLSF_ALIGN_SIZE_LOG2 = (sizeof(size_t) == 8U) ? 3U : 2U;
+
+	/// @brief Blocks smaller than 2^TLSF_FL_INDEX_SHIFT are kept in the first class, linearly subdivided.
+	constexpr uint32_t TLSF_FL_INDEX_SHIFT = (TLSF_SL_INDEX_COUNT_LOG2 + TLSF_ALIGN_SIZE_LOG2);
+
+	/// @brief All blocks are smaller than 2^TLSF_FL_INDEX_MAX.
+	constexpr uint32_t TLSF_FL_INDEX_MAX = (sizeof(size_t) == 8U) ? 38U : 30U;
+
+	/// @brief Number of first level classes. The first level bitmap is 32 bits wide.
+	constexpr uint32_t TLSF_FL_INDEX_COUNT = (TLSF_FL_INDEX_MAX - TLSF_FL_INDEX_SHIFT + 1U);
+
+	/// @brief Size of the first class.
+	constexpr size_t TLSF_SMALL_BLOCK_SIZE = (static_cast<size_t>(1U) << TLSF_FL_INDEX_SHIFT);
+
+	/// @brief The maximal size of a block on a TLSF page.
+	constexpr size_t TLSF_MAX_BLOCK_SIZE = (static_cast<size_t>(1U) << TLSF_FL_INDEX_MAX);
+
+	/// @brief The minimal block size: block header, free list links and the size copy at the end of the block.
+	constexpr size_t TLSF_MIN_BLOCK_SIZE = ((sizeof(rtsha_block) + 2U * sizeof(rtsha_block*) + RTSHA_BLOCK_FOOTER_SIZE + RTSHA_ALIGMENT - 1U) / RTSHA_ALIGMENT) * RTSHA_ALIGMENT;
+
+	/// @brief Size of the allocated internal block at the end of a TLSF page. It stops the merging of the last free block.
+	constexpr size_t TLSF_LAST_BLOCK_SIZE = ((sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE + RTSHA_ALIGMENT - 1U) / RTSHA_ALIGMENT) * RTSHA_ALIGMENT;
+
+	static_assert(TLSF_FL_INDEX_COUNT <= 32U, "The first level bitmap is 32 bits wide.");
+
+	/**
+	* @struct rtsha_tlsf_links
+	* @brief Links of a free block in its segregated list.
+	*
+	* The links are stored in the data area of the free block, directly after the block header.
+	*/
+	struct rtsha_tlsf_links
+	{
+		rtsha_block* next_free;	///< Next free block in the same list.
+		rtsha_block* prev_free;	///< Previous free block in the same list.
+	};
+
+	/**
+	* @class FreeTLSF
+	* @brief Two level segregated fit index of the free blocks of a 'TLSF Memory Page'.
+	*
+	* Free blocks are kept in doubly linked lists. The first level splits the block sizes into power of two classes,
+	* the second level splits every class linearly into 'TLSF_SL_INDEX_COUNT' lists.
+	* Two bitmaps mark the non empty lists so that insertion, removal and search are O(1) operations.
+	* The list links are stored in the free blocks, the index itself does not need any additional memory.
+	*/
+	class alignas(sizeof(size_t)) FreeTLSF
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		FreeTLSF() = delete;
+
+		/**
+		* @brief Constructs an empty index for the provided memory page.
+		*
+		* @param page The rtsha_page that this FreeTLSF will manage.
+		*/
+		explicit FreeTLSF(rtsha_page* page) noexcept;
+
+		/// @brief Destructor for the FreeTLSF.
+		~FreeTLSF() noexcept
+		{
+		}
+
+		/**
+		* @brief Inserts a free block into the list selected by its size.
+		*
+		* @param block The free block.
+		*/
+		void insert(rtsha_block* block) noexcept;
+
+		/**
+		* @brief Removes a free block from its list.
+		*
+		* @param block The free block.
+		*/
+		void remove(rtsha_block* block) noexcept;
+
+		/**
+		* @brief Finds a free block which is at least 'size' bytes large and removes it from the index.
+		*
+		* The search rounds the size up to the next list so that every block of the found list fits (good fit).
+		*
+		* @param size The requested block size.
+		* @return The block or nullptr if there is no block which is large enough.
+		*/
+		rtsha_block* pop(size_t size) noexcept;
+
+		/**
+		* @brief Retrieves the number of the free blocks in the index.
+		*
+		* @return The number of the free blocks.
+		*/
+		rtsha_attr_inline size_t size() const noexcept
+		{
+			return _count;
+		}
+
+	private:
+
+		/**
+		* @brief Calculates the list indices of a block size.
+		*
+		* @param size The block size.
+		* @param fl First level index.
+		* @param sl Second level index.
+		*/
+		rtsha_attr_inline static void mapping_insert(size_t size, uint32_t& fl, uint32_t& sl) noexcept
+		{
+			if (size < TLSF_SMALL_BLOCK_SIZE)
+			{
+				fl = 0U;
+				sl = static_cast<uint32_t>(size / (TLSF_SMALL_BLOCK_SIZE / TLSF_SL_INDEX_COUNT));
+			}
+			else
+			{
+				uint32_t bit = rtsha_fls(size);
+				sl = static_cast<uint32_t>(size >> (bit - TLSF_SL_INDEX_COUNT_LOG2)) ^ TLSF_SL_INDEX_COUNT;
+				fl = bit - (TLSF_FL_INDEX_SHIFT - 1U);
+			}
+		}
+
+		/**
+		* @brief Returns the links stored in the data area of a free block.
+		*
+		* @param block The free block.
+		* @return Pointer to the links.
+		*/
+		rtsha_attr_inline static rtsha_tlsf_links* links(rtsha_block* block) noexcept
+		{
+			return reinterpret_cast<rtsha_tlsf_links*>(reinterpret_cast<address_t>(block) + sizeof(rtsha_block));
+		}
+
+	private:
+		rtsha_page*		_page;													///< The memory page being managed by the index.
+		size_t			_count = 0U;											///< Number of the free blocks in the index.
+		uint32_t		_fl_bitmap = 0U;										///< Non empty first level classes.
+		uint32_t		_sl_bitmap[TLSF_FL_INDEX_COUNT];						///< Non empty second level lists per class.
+		rtsha_block*	_blocks[TLSF_FL_INDEX_COUNT][TLSF_SL_INDEX_COUNT];		///< Heads of the lists.
+	};
+}
@@ -32,8 +32,62 @@ SOFTWARE.
 #include "FreeList.h"
 #include "FreeListArray.h"
 #include "FreeMap.h"
+#include "FreeTLSF.h"
+#include "FreeBuddyBitmap.h"
+#include "FreeSlotBitmap.h"
+#include "HeapSnapshot.h"
+#include "RegionProvider.h"
+#include "memory_kernels.h"
 #include <array>
 
+namespace rtsha
+{
+	/**
+	* @enum rtsha_init_mode
+	* @brief Specifies when the heap memory is set to zero.
+	*/
+	enum struct rtsha_init_mode : uint8_t
+	{
+		InitZeroHeap	= 0U,	///< The whole heap is set to zero by 'init'.
+		InitZeroPages	= 1U,	///< 'init' does not write the heap. A page is set to zero when it is added; on 'Small Fixed Memory Pages' a block is set to zero when it is taken from the untouched area of the page.
+		InitNoZero		= 2U	///< Only the page headers and the metadata are written, e.g. when the memory is zero already.
+	};
+
+	/**
+	* @struct rtsha_warm_up_entry
+	* @brief Number of free blocks of one size prepared by 'Heap::warm_up'.
+	*/
+	struct rtsha_warm_up_entry
+	{
+		size_t	size	= 0U;	///< The size of the blocks, as passed to malloc.
+		size_t	count	= 0U;	///< The number of the blocks.
+	};
+
+	/**
+	* @struct rtsha_reservation
+	* @brief Token of blocks reserved with 'Heap::reserve' for one subsystem.
+	*/
+	struct rtsha_reservation
+	{
+		rtsha_page*	page	= nullptr;	///< The 'Small Fixed Memory Page' holding the reserved blocks.
+		size_t		count	= 0U;		///< The number of reserved blocks which can still be allocated with 'Heap::malloc_reserved'.
+		size_t		in_use	= 0U;		///< The number of blocks allocated with 'Heap::malloc_reserved' and not yet returned with 'Heap::free_reserved'.
+	};
+
+	/**
+	* @struct rtsha_block_ref
+	* @brief Extent of an allocated block resolved once with 'Heap::get_block_ref' and used by the checked copy functions.
+	*
+	* The reference is valid until the block is freed or reallocated. A buffer which does not belong to the heap
+	* can be described by setting both fields.
+	*/
+	struct rtsha_block_ref
+	{
+		address_t	data	= 0U;	///< The data address of the block.
+		size_t		size	= 0U;	///< The number of bytes which can be used from 'data'.
+	};
+}
+
 namespace internal
 {
 	using namespace std;
@@ -55,7 +109,7 @@ namespace internal
 		/**
 	* \brief Standard constructor.
 	*/
-		HeapInternal() noexcept :_big_page_used(false)
+		HeapInternal() noexcept :_big_page_used(false), _tlsf_page_used(false), _bitmap_page_used(false), _arena_page_used(false)
 		{
 			for (size_t i = 0; i < _pages.size(); i++)
 			{
@@ -88,8 +142,8 @@ namespace internal
 
 		/**
 		\brief This function creates a 'Free Map Object' that will be used for the management of the 'free blocks'
-		* Free Map is C++ Standard Library 'multimap' object that implements a sorted associative container,
-		* allowing for fast retrieval of values based on key.
+		* Free Map is a red-black tree of free blocks sorted by the block size. The tree nodes are stored in the free blocks,
+		* so the page does not need any additional map data.
 		*
 		* The object is created in the predifined place on the stack using 'new placement' operator.
 		*
@@ -117,6 +171,58 @@ namespace internal
 		*/
 		FreeListArray* createFreeListArray(rtsha_page* page, size_t page_size) noexcept;
 
+		/**
+		* \brief This function creates a 'Free TLSF Object' that will be used for the management of the TLSF Page 'free blocks'
+		*
+		* Free TLSF object is a two level segregated fit index. The lists are linked through the free blocks.
+		*  The object is created in the predifined place on the stack using 'new placement' operator.
+		*
+		* This function is not intended to be used by users of RTSHA library!
+		*
+		* \param page Pointer to page object's memory.
+		*
+		*
+		* \return On success, a pointer to 'FreeTLSF' object. If the function fails, it returns a null pointer.
+		*/
+		FreeTLSF* createFreeTLSF(rtsha_page* page) noexcept;
+
+		/**
+		* \brief This function creates a 'Free Buddy Bitmap Object' that will be used for the management of the Power Two Bitmap Page blocks
+		*
+		* The object holds the free lists per order. The bitmaps are stored at the head of the page.
+		*  The object is created in the predifined place on the stack using 'new placement' operator.
+		*
+		* This function is not intended to be used by users of RTSHA library!
+		*
+		* \param page Pointer to page object's memory.
+		* \param min_order The order of the smallest block.
+		* \param max_order The order of the top blocks.
+		* \param top_blocks The number of top blocks.
+		* \param bitmap Storage of the bitmaps at the page head.
+		* \param base Address of the first top block.
+		*
+		* \return On success, a pointer to 'FreeBuddyBitmap' object. If the function fails, it returns a null pointer.
+		*/
+		FreeBuddyBitmap* createFreeBuddyBitmap(rtsha_page* page, size_t min_order, size_t max_order, size_t top_blocks, size_t* bitmap, address_t base) noexcept;
+
+		/**
+		* \brief This function creates a 'Free Slot Bitmap Object' that will be used for the management of the Fixed Bitmap Page blocks
+		*
+		* The bitmaps are stored at the head of the page.
+		*  The object is created in the predifined place on the stack using 'new placement' operator.
+		*
+		* This function is not intended to be used by users of RTSHA library!
+		*
+		* \param page Pointer to page object's memory.
+		* \param block_size The size of every block.
+		* \param slots The number of blocks.
+		* \param bitmap Storage of the bitmaps at the page head.
+		* \param base Address of the first block.
+		*
+		* \return On success, a pointer to 'FreeSlotBitmap' object. If the function fails, it returns a null pointer.
+		*/
+		FreeSlotBitmap* createFreeSlotBitmap(rtsha_page* page, size_t block_size, size_t slots, size_t* bitmap, address_t base) noexcept;
+
 
 	protected:
 				
@@ -124,9 +230,8 @@ namespace internal
 		* @brief Initialize a small fixed-sized page.
 		*
 		* @param page Pointer to the `rtsha_page` structure to be initialized.
-		* @param a_size Size of each fixed-sized memory block in the page.
 		*/
-		void init_small_fix_page(rtsha_page* page, size_t a_size) noexcept;
+		void init_small_fix_page(rtsha_page* page) noexcept;
 
 		/**
 		* @brief Initialize a page for handling power-of-two sized memory blocks.
@@ -156,6 +261,91 @@ namespace internal
 		 */
 		void init_big_block_page(rtsha_page* page, size_t a_size, size_t max_objects) noexcept;
 
+		/**
+		* @brief Initialize a page for handling variable sized memory blocks with the 'Two Level Segregated Fit' algorithm.
+		*
+		* @param page Pointer to the `rtsha_page` structure to be initialized.
+		*/
+		void init_tlsf_page(rtsha_page* page) noexcept;
+
+		/**
+		* @brief Initialize a page for power-of-two sized memory blocks without block headers.
+		*
+		* The bitmaps are placed at the page head, the rest of the page is divided into top blocks of 'max_block_size' bytes.
+		*
+		* @param page Pointer to the `rtsha_page` structure to be initialized.
+		* @param min_block_size Minimum size of the memory blocks. It is increased to the nearest power of 2.
+		* @param max_block_size Maximum size of the memory blocks. It is increased to the nearest power of 2.
+		* @return True if at least one top block fits on the page.
+		*/
+		bool init_power_two_bitmap_page(rtsha_page* page, size_t min_block_size, size_t max_block_size) noexcept;
+
+		/**
+		* @brief Initialize a page for memory blocks of a fixed size without block headers.
+		*
+		* The bitmaps are placed at the page head, the rest of the page is divided into blocks of 'block_size' bytes.
+		*
+		* @param page Pointer to the `rtsha_page` structure to be initialized.
+		* @param block_size Size of the memory blocks. It is aligned to the size of the pointer.
+		* @return True if at least one block fits on the page.
+		*/
+		bool init_fixed_bitmap_page(rtsha_page* page, size_t block_size) noexcept;
+
+		/**
+		* @brief Initialize an 'Arena Memory Page'. The page has no map data, the blocks are allocated at the current position.
+		*
+		* @param page Pointer to the `rtsha_page` structure to be initialized.
+		*/
+		void init_arena_page(rtsha_page* page) noexcept;
+
+		/**
+		* @brief Visits the blocks of one page using the page type specific 'MemoryPage' object.
+		*
+		* @param page Pointer to the page to be walked.
+		* @param cursor Walk cursor.
+		* @param max_steps Maximum number of blocks to visit.
+		* @param callback Function called for every visited block.
+		* @param context User context passed to the callback.
+		* @return The number of visited blocks.
+		*/
+		size_t walk_page(rtsha_page* page, rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept;
+
+		/**
+		* @brief Commits more memory of the reserved region, so that 'size' bytes are available at the current position.
+		*
+		* @param size The number of bytes needed at the current position of the heap.
+		* @return False if there is no region provider, the hard cap is reached or the memory can not be committed.
+		*/
+		bool grow_heap(size_t size) noexcept;
+
+		/**
+		* @brief Checks if the index object of a new page of the given type can still be created.
+		*
+		* @param size_type The type of the page.
+		* @return False if the storage of the index objects of the page type is used up.
+		*/
+		bool has_page_storage(rtsha_page_size_type size_type) const noexcept;
+
+		/**
+		* @brief Enters a 'Small Fix Memory Page' into the size class table.
+		*
+		* Every aligned size up to the block size of the page is mapped to the page, unless it is already
+		* mapped to a page with a smaller block size.
+		*
+		* @param page_index Index of the page in the array of pages.
+		*/
+		void add_size_class(size_t page_index) noexcept;
+
+		/**
+		* @brief Enters a 'Power Two Bitmap Memory Page' or a 'Fixed Bitmap Memory Page' into the bitmap class table.
+		*
+		* Every aligned size up to the maximal block size of the page is mapped to the page, unless it is already
+		* mapped to a page with a smaller maximal block size.
+		*
+		* @param page_index Index of the page in the array of pages.
+		*/
+		void add_bitmap_class(size_t page_index) noexcept;
+
 	protected:
 
 		/**
@@ -170,6 +360,23 @@ namespace internal
 		*/
 		size_t		_number_pages = 0U;
 
+		/**
+		* @brief Size class table. Entry 'i' holds the index + 1 of the 'Small Fix Memory Page' with the smallest
+		* block size not smaller than '(i + 1) * RTSHA_ALIGMENT' bytes, or 0 if there is no such page.
+		*/
+		std::array<uint8_t, RTSHA_SIZE_CLASSES>	_size_classes{};
+
+		/**
+		* @brief Bitmap class table. Entry 'i' holds the index + 1 of the page without block headers with the smallest
+		* maximal block size not smaller than '(i + 1) * RTSHA_ALIGMENT' bytes, or 0 if there is no such page.
+		*/
+		std::array<uint8_t, RTSHA_SIZE_CLASSES>	_bitmap_classes{};
+
+		/**
+		* @brief The largest maximal block size of the pages without block headers. Larger requests skip these pages.
+		*/
+		size_t		_bitmap_max_block_size = 0U;
+
 		/**
 		* @brief Starting address of the heap.
 		*/
@@ -197,6 +404,41 @@ namespace internal
 		*/
 		bool		_heap_init = false;
 
+		/**
+		* @brief Specifies when the heap memory is set to zero.
+		*/
+		rtsha_init_mode			_init_mode = rtsha_init_mode::InitZeroHeap;
+
+		/**
+		* @brief Function setting the heap memory to zero, or null pointer to use 'memset'.
+		*/
+		rtshZeroMemoryPtr		_zero_function = nullptr;
+
+		/**
+		* @brief Upstream provider of the heap memory, or null pointer if the heap is a fixed region.
+		*/
+		RegionProviderStruct*	_provider = nullptr;
+
+		/**
+		* @brief The region provider owned by the heap, used by 'init_mapped'.
+		*/
+		RegionProviderStruct	_mapped_provider = {};
+
+		/**
+		* @brief The end of the reserved region, the hard cap of the heap.
+		*/
+		address_t	_heap_limit = 0U;
+
+		/**
+		* @brief Size of the pages appended to the heap when a size class runs out. 0 disables the growth.
+		*/
+		size_t		_grow_page_size = 0U;
+
+		/**
+		* @brief Copies and fills of at least this size use non-temporal stores. 0 disables the streaming.
+		*/
+		size_t		_stream_threshold = 0U;
+
 		/**
 		* @brief Last error code related to heap operations.
 		*
@@ -211,6 +453,21 @@ namespace internal
 		*/
 		bool _big_page_used;
 
+		/**
+		* @brief Indicates that heap uses 'TLSF memory' page
+		*/
+		bool _tlsf_page_used;
+
+		/**
+		* @brief Indicates that heap uses 'Power Two Bitmap memory' or 'Fixed Bitmap memory' page
+		*/
+		bool _bitmap_page_used;
+
+		/**
+		* @brief Indicates that heap uses 'Arena memory' page
+		*/
+		bool _arena_page_used;
+
 
 		/**
 		 * @brief Reserved storage on the stack for `FreeList` objects.
@@ -235,6 +492,30 @@ namespace internal
 		* ensures there's space for them on the stack.
 		*/
 		PREALLOC_MEMORY<FreeMap, MAX_BIG_PAGES>		_storage_free_maps = 0U;
+
+		/**
+		* @brief Reserved storage on the stack for `FreeTLSF` objects.
+		*
+		* These area is reserver for objects that will be created with placement new operator, and this storage
+		* ensures there's space for them on the stack.
+		*/
+		PREALLOC_MEMORY<FreeTLSF, MAX_TLSF_PAGES>	_storage_free_tlsf = 0U;
+
+		/**
+		* @brief Reserved storage on the stack for `FreeBuddyBitmap` objects.
+		*
+		* These area is reserver for objects that will be created with placement new operator, and this storage
+		* ensures there's space for them on the stack.
+		*/
+		PREALLOC_MEMORY<FreeBuddyBitmap, MAX_POWER_TWO_BITMAP_PAGES>	_storage_free_buddy = 0U;
+
+		/**
+		* @brief Reserved storage on the stack for `FreeSlotBitmap` objects.
+		*
+		* These area is reserver for objects that will be created with placement new operator, and this storage
+		* ensures there's space for them on the stack.
+		*/
+		PREALLOC_MEMORY<FreeSlotBitmap, MAX_FIXED_BITMAP_PAGES>	_storage_free_slots = 0U;
 	};
 }
 
@@ -274,6 +555,59 @@ namespace rtsha
 		*/
 		bool init(void* start, size_t size) noexcept;
 
+		/**
+		* \brief This function initializes the heap and specifies when its memory is set to zero.
+		*
+		* Setting a large heap to zero at once delays the start of the system, and on systems with virtual memory every page of the heap is faulted in.
+		* With 'InitZeroPages' the memory of a page is set to zero only when the page is added, and the blocks of 'Small Fixed Memory Pages' when
+		* they are allocated for the first time. With 'InitNoZero' only the page headers and the metadata are written.
+		*
+		* \param start The beginning of heap memory.
+		* \param size The size of heap memory.
+		* \param mode Specifies when the heap memory is set to zero.
+		* \param zero_function The function which sets the memory to zero, e.g. split across worker threads. nullptr to use 'memset'.
+		* \return Returns true when the heap has been sucessfuly created.
+		*/
+		bool init(void* start, size_t size, rtsha_init_mode mode, rtshZeroMemoryPtr zero_function = nullptr) noexcept;
+
+		/**
+		* \brief This function initializes a growable heap on memory of an upstream region provider.
+		*
+		* The address space for 'max_size' bytes is reserved at once and 'initial_size' bytes are committed. When a page does not fit
+		* into the committed memory, more memory is committed, up to 'max_size'. The reserved region is released by the destructor.
+		*
+		* \param provider The region provider, e.g. filled by 'rtsha_mmap_region_provider'. It must stay valid while the heap is used.
+		* \param initial_size The size of the memory committed at once.
+		* \param max_size The hard cap of the heap size.
+		* \return Returns true when the heap has been sucessfuly created.
+		*/
+		bool init(RegionProviderStruct* provider, size_t initial_size, size_t max_size) noexcept;
+
+		/**
+		* \brief This function initializes a growable heap on virtual memory mapped by the heap itself.
+		*
+		* The heap fills its own region provider with 'rtsha_mmap_region_provider' and the options, e.g. to back the heap by huge pages
+		* which are faulted in and locked into RAM when they are committed. This removes TLB misses and first-touch page faults from the allocations.
+		* With 'RTSHA_MMAP_HUGE_PAGES' the region starts at a huge page boundary and is committed in whole huge pages.
+		*
+		* \param initial_size The size of the memory committed at once.
+		* \param max_size The hard cap of the heap size.
+		* \param options A combination of the RTSHA_MMAP_OPTIONS (MmapRegionProvider.h).
+		* \return Returns true when the heap has been sucessfuly created. False also if an option is not supported on the target.
+		*/
+		bool init_mapped(size_t initial_size, size_t max_size, uint32_t options) noexcept;
+
+		/**
+		* \brief This function enables appending of new pages when a size class runs out.
+		*
+		* When a 'Small Fixed Memory Page' of a size class is full, a new page with the same block size is appended and takes over the class;
+		* the full pages are used again when blocks have been released on them. When all 'TLSF Memory Pages' are full, a new 'TLSF Memory Page' is appended.
+		* The pages are taken from the free space of the heap, which is extended by the region provider of a growable heap.
+		*
+		* \param page_size The size of the appended pages. 0 disables the growth.
+		*/
+		void set_page_growth(size_t page_size) noexcept;
+
 
 		/**
 		* \brief This function creates memory page and adds it to the heap. RTSHA supports more than one pages per heap.
@@ -299,9 +633,27 @@ namespace rtsha
 		*/
 		bool add_page(HeapCallbacksStruct* callbacks, rtsha_page_size_type size_type, size_t size, size_t max_objects = 0U, size_t min_block_size = 0U, size_t max_block_size = 0U) noexcept;
 
+		/**
+		* \brief This function creates a 'Small Fixed Memory Page' owned by a single object pool and adds it to the heap.
+		*
+		* The page is not used by malloc. Its blocks are taken and returned by the owner directly (see ObjectPool).
+		* Blocks of the page can still be released with free.
+		*
+		* \param callbacks The HeapCallbacksStruct with callback functions when used. nullptr if 'callback' functions are not used.
+		*
+		* \param size The size of the page.
+		*
+		* \param block_size The size of every page block including the block header. It must be aligned to RTSHA_ALIGMENT.
+		*
+		* \return Returns pointer to the created page or null pointer if the function fails.
+		*/
+		rtsha_page* add_pool_page(HeapCallbacksStruct* callbacks, size_t size, size_t block_size) noexcept;
+
 		/**
 		* \brief This function reurns deww space of the heap.
 		*
+		* For a growable heap the not yet committed part of the reserved region is included.
+		*
 		* \return Returns the number of free bytes on the heap.
 		*/
 		size_t get_free_space() const noexcept;
@@ -348,6 +700,213 @@ namespace rtsha
 		*/
 		void free(void* ptr) noexcept;
 
+		/**
+		* \brief This function deallocates memory block of known size.
+		*
+		* A block allocated on a 'Small Fixed Memory Page' is released on the page of its size class, without searching the page list.
+		* Other blocks are released with 'free'.
+		*
+		* \param ptr Pointer to a previously allocated memory block.
+		*
+		* \param size The size which was requested when the block was allocated.
+		*/
+		void free_sized(void* ptr, size_t size) noexcept;
+
+		/**
+		* \brief This function allocates the block of memory on the given page.
+		*
+		* \param page Pointer to a page of the heap. The page may also be a dedicated page.
+		*
+		* \param size Size of the memory block, in bytes.
+		*
+		* \return On success, a pointer to the memory block or null pointer if the block does not fit on the page.
+		*/
+		void* page_malloc(rtsha_page* page, size_t size) noexcept;
+
+		/**
+		* \brief This function deallocates memory block allocated on the given page, without searching the page list.
+		*
+		* \param page Pointer to the page on which the block has been allocated.
+		*
+		* \param ptr Pointer to a memory block returned by page_malloc or malloc.
+		*/
+		void page_free(rtsha_page* page, void* ptr) noexcept;
+
+		/**
+		* \brief This function enables or disables deferred coalescing on a 'Big Memory Page'.
+		*
+		* In deferred mode 'free' only marks the block as free and pushes it to a list of deferred blocks, so the release takes constant time.
+		* The deferred blocks are reused for requests of the same size. They are merged with their neighbours when an allocation can not be
+		* satisfied or when 'coalesce' is called. All deferred blocks are merged when the mode is disabled.
+		*
+		* \param page Pointer to a 'Big Memory Page'.
+		*
+		* \param enable True to enable deferred coalescing.
+		*
+		* \return Returns false if the page is not a 'Big Memory Page'.
+		*/
+		bool set_deferred_coalescing(rtsha_page* page, bool enable) noexcept;
+
+		/**
+		* \brief This function merges blocks released in deferred mode with their free neighbours.
+		*
+		* The function is intended to be called from an idle task. The amount of work is limited by the budget.
+		*
+		* \param budget Maximum number of deferred blocks to merge.
+		*
+		* \return Returns the number of merged blocks.
+		*/
+		size_t coalesce(size_t budget) noexcept;
+
+		/**
+		* \brief This function prepares free blocks before the real time phase of the application.
+		*
+		* On 'Small Fixed Memory Pages' the blocks are taken from the untouched area of the page and put to the free list.
+		* On 'Power Two Memory Pages' larger blocks are split into blocks of the requested size, which are released without merging them with their buddies.
+		* The data of the blocks is written, so the memory is faulted in. The following allocations of these sizes take a block from a free list.
+		* The blocks on 'Big Memory Pages' and 'TLSF Memory Pages' are merged again when they are released, their memory is only touched.
+		*
+		* \param plan The sizes and the numbers of the blocks, e.g. { {256U, 200U}, {2048U, 50U} }.
+		*
+		* \param entries The number of entries of the plan.
+		*
+		* \return Returns false if the heap does not have enough memory for all blocks.
+		*/
+		bool warm_up(const rtsha_warm_up_entry* plan, size_t entries) noexcept;
+
+		/**
+		* \brief This function reserves blocks of a size class for one subsystem.
+		*
+		* The reserved blocks are not taken by malloc, so the subsystem can not run out of blocks when other tasks use up the page.
+		* The reservation is accounted by a counter of the page, the check in malloc takes constant time.
+		*
+		* \param size The size of the blocks, as passed to malloc. It must be served by a 'Small Fixed Memory Page'.
+		*
+		* \param count The number of the blocks.
+		*
+		* \param token The token of the reservation. A token can be extended by further calls for the same size.
+		*
+		* \return Returns false if the page of the class has less than 'count' blocks which are not reserved.
+		*/
+		bool reserve(size_t size, size_t count, rtsha_reservation& token) noexcept;
+
+		/**
+		* \brief This function allocates one of the blocks of a reservation.
+		*
+		* \param token The token of the reservation.
+		*
+		* \return On success, a pointer to the memory block or null pointer if all blocks of the reservation are in use.
+		*/
+		void* malloc_reserved(rtsha_reservation& token) noexcept;
+
+		/**
+		* \brief This function deallocates a block allocated by 'malloc_reserved' and returns it to the reservation.
+		*
+		* The blocks of a reservation must be returned with this function. A reserved block released with 'free' goes to the
+		* blocks used by malloc and the reservation stays one block smaller. The call is rejected with 'RTSHA_InvalidBlock'
+		* when no block of the reservation is in use, so a block allocated by malloc can not extend the reservation.
+		*
+		* \param token The token of the reservation.
+		*
+		* \param ptr Pointer to a memory block returned by 'malloc_reserved'.
+		*/
+		void free_reserved(rtsha_reservation& token, void* ptr) noexcept;
+
+		/**
+		* \brief This function returns the blocks of a reservation which are not in use to the blocks used by malloc.
+		*
+		* The blocks still in use are released with 'free' afterwards.
+		*
+		* \param token The token of the reservation. It is cleared.
+		*/
+		void release_reservation(rtsha_reservation& token) noexcept;
+
+		/**
+		* \brief This function moves unused memory of the 'Small Fixed Memory Pages' to a size class which runs out of blocks.
+		*
+		* The donor is the fixed size page of another class with the largest untouched area at its end, the area which has never been allocated.
+		* The end of the donor is moved down and a new page of the given class is created in the released range. The new page takes over the class;
+		* the previous page of the class is used again when blocks have been released on it.
+		*
+		* \param page The current page of the size class, returned by 'select_fixed_page'.
+		*
+		* \param size The size of the new page.
+		*
+		* \return Returns pointer to the created page or null pointer if no page has enough untouched memory.
+		*/
+		rtsha_page* rebalance_page(rtsha_page* page, size_t size) noexcept;
+
+		/**
+		* \brief This function moves unused memory to every size class which runs low on blocks.
+		*
+		* The function is intended to be called from a maintenance task, so the memory is moved before the classes run out.
+		* 'rebalance_page' is called for every class which can allocate less than 'min_blocks' blocks without a new page.
+		*
+		* \param size The size of the new pages.
+		*
+		* \param min_blocks The number of blocks each size class should be able to allocate.
+		*
+		* \return Returns the number of created pages.
+		*/
+		size_t rebalance(size_t size, size_t min_blocks) noexcept;
+
+		/**
+		* \brief This function creates an 'Arena Memory Page' and adds it to the heap.
+		*
+		* The page is not used by malloc. The blocks are allocated with 'arena_malloc' and released all at once with 'arena_reset' or 'arena_rewind'.
+		*
+		* \param callbacks The HeapCallbacksStruct with callback functions when used. nullptr if 'callback' functions are not used.
+		*
+		* \param size The size of the page.
+		*
+		* \return Returns pointer to the created page or null pointer if the function fails.
+		*/
+		rtsha_page* add_arena_page(HeapCallbacksStruct* callbacks, size_t size) noexcept;
+
+		/**
+		* \brief This function allocates a block on an 'Arena Memory Page' by advancing the position of the page.
+		*
+		* The block has no header. It must not be passed to free or realloc, it is released by 'arena_reset' or 'arena_rewind'.
+		*
+		* \param page Pointer to an 'Arena Memory Page'.
+		*
+		* \param size Size of the memory block, in bytes.
+		*
+		* \param alignment Alignment of the memory block, a power of two.
+		*
+		* \return On success, a pointer to the memory block or null pointer if the page is full.
+		*/
+		void* arena_malloc(rtsha_page* page, size_t size, size_t alignment = RTSHA_ALIGMENT) noexcept;
+
+		/**
+		* \brief This function returns the current position of an 'Arena Memory Page'.
+		*
+		* \param page Pointer to an 'Arena Memory Page'.
+		*
+		* \return The marker which can be passed to 'arena_rewind', or 0 if the page is not an 'Arena Memory Page'.
+		*/
+		address_t arena_marker(rtsha_page* page) noexcept;
+
+		/**
+		* \brief This function releases all blocks allocated on an 'Arena Memory Page' after the marker was taken.
+		*
+		* \param page Pointer to an 'Arena Memory Page'.
+		*
+		* \param marker A value returned by 'arena_marker'.
+		*
+		* \return Returns false if the page is not an 'Arena Memory Page' or the marker is not valid.
+		*/
+		bool arena_rewind(rtsha_page* page, address_t marker) noexcept;
+
+		/**
+		* \brief This function releases all blocks allocated on an 'Arena Memory Page'.
+		*
+		* \param page Pointer to an 'Arena Memory Page'.
+		*
+		* \return Returns false if the page is not an 'Arena Memory Page'.
+		*/
+		bool arena_reset(rtsha_page* page) noexcept;
+
 		/**
 		* \brief This function allocates the block of memory on the heap and initializes it to zero.
 		*
@@ -389,7 +948,7 @@ namespace rtsha
 		* Before copying memory from the source to the destination, the function checks if the source and destination memory addresses belong to the heap,
 		* whether the destination block is valid and not free, and if the size of the destination block is sufficiently large.
 		* If the destination does not belong to the heap memory, it will simply perform the copy function.
-		* Standard memcpy function is used.
+		* The copy is performed by the widest kernel of the target, see 'rtsha_copy'.
 		*
 		* \param _Dst Pointer to the destination.
 		*
@@ -405,7 +964,7 @@ namespace rtsha
 		/**
 		* \brief This function sets values of num bytes from the location pointed to by _Dst to the specified value.
 		*
-		* Before calling standard 'memset' function, this function checks if the destination memory addresses belong to the heap,
+		* Before filling the memory with the widest kernel of the target (see 'rtsha_fill'), this function checks if the destination memory addresses belong to the heap,
 		* whether the destination block is valid and not free, and if the size of the destination block is sufficiently large.
 		* If the destination does not belong to the heap memory, it will simply perform the function.
 		*
@@ -420,6 +979,137 @@ namespace rtsha
 		*/
 		void* memset(void* _Dst, int _Val, size_t _Size) noexcept;
 
+		/**
+		* \brief This function resolves the extent of an allocated block for repeated checked copies.
+		*
+		* The page of the block is resolved and the block is validated only here, the copy functions taking
+		* 'rtsha_block_ref' compare the ranges with the cached extent in constant time.
+		* A block of the current 'Small Fixed Memory Page' of its size class is resolved in constant time through the
+		* size class table. For the blocks of other pages the resolution costs one search of the pages.
+		*
+		* \param ptr The pointer returned by malloc, or an address returned by 'arena_malloc'.
+		*
+		* \param ref The reference which receives the extent.
+		*
+		* \return Returns false if the address is not an allocated block of the heap.
+		*/
+		bool get_block_ref(void* ptr, rtsha_block_ref& ref) noexcept;
+
+		/**
+		* \brief This function copies bytes between two resolved blocks.
+		*
+		* Both ranges are checked against the cached extents, the blocks are not searched again.
+		*
+		* \param dst The destination block.
+		*
+		* \param dst_offset The offset of the destination range in the destination block.
+		*
+		* \param src The source block.
+		*
+		* \param src_offset The offset of the source range in the source block.
+		*
+		* \param size Number of bytes to copy.
+		*
+		* \return On success, a pointer to the destination memory, or null pointer if a range exceeds its block.
+		*/
+		void* memcpy(const rtsha_block_ref& dst, size_t dst_offset, const rtsha_block_ref& src, size_t src_offset, size_t size) noexcept;
+
+		/**
+		* \brief This function sets bytes of a resolved block to the specified value.
+		*
+		* \param dst The destination block.
+		*
+		* \param dst_offset The offset of the range in the block.
+		*
+		* \param value Value to be set.
+		*
+		* \param size Number of bytes to be set.
+		*
+		* \return On success, a pointer to the destination memory, or null pointer if the range exceeds the block.
+		*/
+		void* memset(const rtsha_block_ref& dst, size_t dst_offset, int value, size_t size) noexcept;
+
+		/**
+		* \brief This function sets the size from which 'memcpy' and 'memset' write around the caches.
+		*
+		* Large copies and fills use non-temporal stores ('rtsha_copy_stream', 'rtsha_fill_stream'), so bulk data moved
+		* by a background task does not evict the cached working set of the real time tasks. The data is not in the cache
+		* after the copy, the threshold should be above the size of the buffers which are read again at once.
+		*
+		* \param size The size in bytes. 0 disables the streaming.
+		*/
+		void set_stream_threshold(size_t size) noexcept;
+
+		/**
+		* \brief This function visits all blocks of all heap pages.
+		*
+		* The walk does not allocate any memory. For every block the callback receives the block address,
+		* size, 'free' and 'last' flags and the type of the page.
+		* Each page is locked only while a block header is read, so the function can be used from a low-priority task.
+		*
+		* \param callback Function called for every block. The walk stops when the callback returns false.
+		*
+		* \param context User context passed to the callback.
+		*
+		* \return Returns true when the walk has been finished.
+		*/
+		bool walk(rtshWalkBlockPtr callback, void* context) noexcept;
+
+		/**
+		* \brief This function visits at most 'max_steps' blocks and stores the position in the cursor.
+		*
+		* The walk can be resumed by calling the function again with the same cursor.
+		* If a page has been changed between two calls so that the stored block does not exist any more,
+		* the walk continues with the next page and 'inconsistent' is set in the cursor.
+		*
+		* \param cursor The walk cursor. A default constructed cursor starts at the first page.
+		*
+		* \param max_steps Maximum number of blocks to visit in this call.
+		*
+		* \param callback Function called for every block. The walk stops when the callback returns false.
+		*
+		* \param context User context passed to the callback.
+		*
+		* \return Returns true when the walk has been finished.
+		*/
+		bool walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept;
+
+		/**
+		* \brief This function writes a compact binary snapshot of the heap using the specified writer.
+		*
+		* The snapshot contains all page descriptors, block headers and a summary of the free structures of every page.
+		* The format is described in 'HeapSnapshot.h'. No memory is allocated while the snapshot is written.
+		*
+		* \param writer Function which writes a chunk of the snapshot.
+		*
+		* \param context User context passed to the writer.
+		*
+		* \return Returns true when the whole snapshot has been written.
+		*/
+		bool snapshot(rtshSnapshotWritePtr writer, void* context) noexcept;
+
+		/**
+		* \brief This function writes a compact binary snapshot of the heap into the caller-provided buffer.
+		*
+		* \param buffer Destination buffer.
+		*
+		* \param size Size of the destination buffer in bytes.
+		*
+		* \return Returns the number of written bytes or 0 when the buffer is too small.
+		*/
+		size_t snapshot(void* buffer, size_t size) noexcept;
+
+#if defined(_MSC_VER) || defined(__unix__) || defined(__APPLE__)
+		/**
+		* \brief This function writes a compact binary snapshot of the heap to the file descriptor.
+		*
+		* \param fd Open file descriptor.
+		*
+		* \return Returns true when the whole snapshot has been written.
+		*/
+		bool snapshot_to_fd(int fd) noexcept;
+#endif
+
 
 		/**
 		* \brief This function returns ideal page type based on size criteria.
@@ -447,6 +1137,219 @@ namespace rtsha
 		*/
 		rtsha_page* select_page(rtsha_page_size_type ideal_page, size_t size, bool no_big = false) const noexcept;
 
+		/**
+		* \brief This function returns the 'Small Fix Memory Page' with the smallest block size which can hold the block.
+		*
+		* The page is taken from the size class table in constant time.
+		*
+		* \param size Size of the memory block including the block header, in bytes.
+		*
+		* \return Returns pointer to rtsha_page structure or null pointer if there is no such page.
+		*/
+		rtsha_attr_inline rtsha_page* select_fixed_page(size_t size) const noexcept
+		{
+			if ((size == 0U) || (size > RTSHA_MAX_FIXED_BLOCK_SIZE))
+			{
+				return nullptr;
+			}
+			const uint8_t index = _size_classes[(size - 1U) / RTSHA_ALIGMENT];
+			return (index != 0U) ? _pages[index - 1U] : nullptr;
+		}
+
+	private:
+
+		/**
+		* \brief This function creates memory page and adds it to the heap.
+		*
+		* The parameters are the same as for add_page.
+		*
+		* \param dedicated Indicates that the page is owned by an object pool and must not be used by malloc.
+		*
+		* \param position Address of the page inside a range released by another page. 0 places the page at the end of the heap.
+		*
+		* \return On success, a pointer to the created page or null pointer if the function fails.
+		*/
+		rtsha_page* create_page(HeapCallbacksStruct* callbacks, rtsha_page_size_type size_type, size_t size, size_t max_objects, size_t min_block_size, size_t max_block_size, bool dedicated, address_t position = 0U) noexcept;
+
+		/**
+		* \brief This function allocates a block on a page without block headers ('Power Two Bitmap Memory Page' or 'Fixed Bitmap Memory Page').
+		*
+		* The page with the smallest maximal block size which can hold the requested size is used first. It is taken from
+		* the bitmap class table in constant time, the pages are searched only when it is full.
+		*
+		* \param size Size of the memory block, in bytes. No block header is added.
+		*
+		* \return On success, a pointer to the memory block or null pointer if the function fails.
+		*/
+		void* malloc_bitmap_page(size_t size) noexcept;
+
+		/**
+		* \brief This function allocates a block on a given page without block headers.
+		*/
+		void* allocate_bitmap_block(rtsha_page* page, size_t size) noexcept;
+
+		/**
+		* \brief This function allocates a block of a size class whose page is full.
+		*
+		* The previous pages of the class are tried first, then a new page of the class is appended.
+		*
+		* \param page The current page of the size class.
+		*
+		* \return On success, a pointer to the memory block or null pointer if the function fails.
+		*/
+		void* malloc_grown_class(rtsha_page* page) noexcept;
+
+		/**
+		* \brief This function allocates a block of variable size when the selected page is full.
+		*
+		* The other 'TLSF Memory Pages' are tried first, then a new 'TLSF Memory Page' is appended.
+		*
+		* \param a_size Size of the memory block including the block header, aligned.
+		*
+		* \param full The page on which the allocation has failed.
+		*
+		* \return On success, a pointer to the memory block or null pointer if the function fails.
+		*/
+		void* malloc_grown_variable(size_t a_size, const rtsha_page* full) noexcept;
+
+		/**
+		* \brief This function releases a block on its page using the page type specific 'MemoryPage' object.
+		*
+		* \param page The page owning the block.
+		*
+		* \param ptr The address returned by the allocation. The header of the block must have been validated.
+		*/
+		void free_on_page(rtsha_page* page, void* ptr) noexcept;
+
+		/**
+		* \brief This function sets a part of the heap to zero using the zero function of the heap.
+		*/
+		rtsha_attr_inline void zero_memory(address_t address, size_t size) const noexcept
+		{
+			if (_zero_function != nullptr)
+			{
+				_zero_function(reinterpret_cast<void*>(address), size);
+			}
+			else
+			{
+				::memset(reinterpret_cast<void*>(address), 0, size);
+			}
+		}
+
+		/**
+		* \brief This function prepares free blocks of one size, see 'warm_up'.
+		*
+		* \param size The size of the blocks, as passed to malloc.
+		*
+		* \param count The number of the blocks.
+		*
+		* \return Returns false if the heap does not have enough memory for the blocks.
+		*/
+		bool warm_up_blocks(size_t size, size_t count) noexcept;
+
+		/**
+		* \brief This function lets the page take over the size classes of the current page of its class.
+		*
+		* \param page The new page of the class. It must be the last page added to the heap.
+		*
+		* \param current The current page of the class.
+		*
+		* \param current_index The index of the current page.
+		*/
+		void take_over_class(rtsha_page* page, rtsha_page* current, size_t current_index) noexcept;
+
+		/**
+		* \brief This function returns the index of the page when it is the current page of a size class.
+		*
+		* \return The index of the page or the number of pages if the page does not serve a size class.
+		*/
+		size_t get_class_page_index(const rtsha_page* page) const noexcept;
+
+		/**
+		* \brief This function returns the number of blocks which can still be allocated in a size class without a new page.
+		*
+		* \param page The current page of the class.
+		*/
+		size_t get_class_blocks(rtsha_page* page) noexcept;
+
+		/**
+		* \brief This function checks if the page is a 'Small Fixed Memory Page' used by malloc.
+		*/
+		rtsha_attr_inline static bool is_class_page(const rtsha_page* page) noexcept
+		{
+			/*the page type values of the other pages are odd numbers*/
+			return (page != nullptr) && (!page->dedicated) && ((page->flags % RTSHA_ALIGMENT) == 0U) &&
+				(page->flags <= RTSHA_MAX_FIXED_BLOCK_SIZE);
+		}
+
+		/**
+		* \brief This function checks if the page is a page without block headers ('Power Two Bitmap Memory Page' or 'Fixed Bitmap Memory Page').
+		*/
+		rtsha_attr_inline static bool is_bitmap_page(const rtsha_page* page) noexcept
+		{
+			return (page != nullptr) && ((page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap)) ||
+										 (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap)));
+		}
+
+		/**
+		* \brief This function checks if the page is an 'Arena Memory Page'.
+		*/
+		rtsha_attr_inline static bool is_arena_page(const rtsha_page* page) noexcept
+		{
+			return (page != nullptr) && (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeArena));
+		}
+
+		/**
+		* \brief This function returns the size of an allocated block on a page without block headers.
+		*
+		* \param page A page without block headers.
+		* \param address The data address of a block.
+		*
+		* \return The size of the block or 0 if the address is not an allocated block of the page.
+		*/
+		size_t bitmap_usable_size(rtsha_page* page, address_t address) noexcept;
+
+		/**
+		* \brief This function returns the number of bytes which can be used from an address of a page.
+		*
+		* \param page The page returned by 'get_block_page'.
+		* \param address The data address of a block, or an address within the allocated area of an 'Arena Memory Page'.
+		*
+		* \return The number of bytes or 0 if the address is not an allocated block of the page.
+		*/
+		size_t block_extent(rtsha_page* page, address_t address) noexcept;
+
+		/**
+		* \brief This function copies memory with the streaming kernel when the size reaches the stream threshold.
+		*/
+		rtsha_attr_inline void* copy_memory(void* dst, const void* src, size_t size) const noexcept
+		{
+			if ((_stream_threshold != 0U) && (size >= _stream_threshold))
+			{
+				return rtsha_copy_stream(dst, src, size);
+			}
+			return rtsha_copy(dst, src, size);
+		}
+
+		/**
+		* \brief This function fills memory with the streaming kernel when the size reaches the stream threshold.
+		*/
+		rtsha_attr_inline void* fill_memory(void* dst, int value, size_t size) const noexcept
+		{
+			if ((_stream_threshold != 0U) && (size >= _stream_threshold))
+			{
+				return rtsha_fill_stream(dst, value, size);
+			}
+			return rtsha_fill(dst, value, size);
+		}
+
+		/**
+		* \brief This function checks that 'size' bytes fit into a reference from 'offset' on.
+		*/
+		rtsha_attr_inline static bool fits_block_ref(const rtsha_block_ref& ref, size_t offset, size_t size) noexcept
+		{
+			return (ref.data != 0U) && (offset <= ref.size) && (size <= (ref.size - offset));
+		}
 	};
 }
 
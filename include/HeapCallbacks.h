@@ -44,6 +44,16 @@ typedef void (*rtshUnLockPagePtr)	(void);
  */
 typedef void (*rtshErrorPagePtr)	(uint32_t);
 
+/**
+ * @brief A function pointer type for setting heap memory to zero.
+ *
+ * The function can split the range and set the parts to zero on worker threads; it must return when the whole range is zero.
+ *
+ * @param address The start of the memory.
+ * @param size The size of the memory.
+ */
+typedef void (*rtshZeroMemoryPtr)	(void* address, size_t size);
+
 /**
  * @struct HeapCallbacksStruct
  * @brief Represents a collection of callback functions for heap operations.
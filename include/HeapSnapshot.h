@@ -0,0 +1,138 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+/** @defgroup RTSHA_SNAPSHOT RTSHA Heap Snapshot Format
+ *  Binary layout of the heap snapshot written by 'Heap::snapshot'.
+ *
+ *  The snapshot is a sequence of little-endian records without padding:
+ *
+ *  rtsha_snapshot_header
+ *  for each page:
+ *      rtsha_snapshot_page
+ *      rtsha_snapshot_block  (one record for every block of the page)
+ *      rtsha_snapshot_block  (end marker, offset = RTSHA_SNAPSHOT_END_OF_PAGE)
+ *      rtsha_snapshot_page_summary
+ *
+ *  The header is self-contained, so that an offline analyzer running on a different platform can read the snapshot.
+ *  @{
+ */
+
+/** @brief Magic number of the snapshot ('RTSH'). */
+#define RTSHA_SNAPSHOT_MAGIC				(0x48535452U)
+
+/** @brief Version of the snapshot format. */
+#define RTSHA_SNAPSHOT_VERSION				(1U)
+
+/** @brief Offset value of the block record which terminates the list of page blocks. */
+#define RTSHA_SNAPSHOT_END_OF_PAGE			(0xFFFFFFFFU)
+
+/** @brief Block record flag: the block is free. */
+#define RTSHA_SNAPSHOT_BLOCK_FREE			(1U)
+
+/** @brief Block record flag: the block is the last block of the page. */
+#define RTSHA_SNAPSHOT_BLOCK_LAST			(2U)
+
+/** @brief Page summary flag: the page has been changed while the snapshot was taken. */
+#define RTSHA_SNAPSHOT_PAGE_INCONSISTENT	(1U)
+
+/** @brief Page summary flag: the page is too big for 32 bit block records and the blocks are not included. */
+#define RTSHA_SNAPSHOT_PAGE_NO_BLOCKS		(2U)
+
+/**
+* @struct rtsha_snapshot_header
+* @brief The first record of the snapshot.
+*/
+struct rtsha_snapshot_header
+{
+	uint32_t	magic;				///< RTSHA_SNAPSHOT_MAGIC
+	uint16_t	version;			///< RTSHA_SNAPSHOT_VERSION
+	uint16_t	address_size;		///< Size of the address (sizeof(size_t)) on the target.
+	uint32_t	number_pages;		///< Number of page records which follow the header.
+	uint32_t	last_error;			///< Last heap error.
+	uint64_t	heap_start;			///< Start address of the heap.
+	uint64_t	heap_size;			///< Size of the heap in bytes.
+	uint64_t	heap_free;			///< Free space of the heap which has not been assigned to pages.
+};
+
+/**
+* @struct rtsha_snapshot_page
+* @brief Page descriptor record.
+*/
+struct rtsha_snapshot_page
+{
+	uint32_t	page_type;			///< Page type (rtsha_page_size_type).
+	uint32_t	index;				///< Index of the page in the heap.
+	uint64_t	start_position;		///< Start address of page data.
+	uint64_t	end_position;		///< End address of the page.
+	uint64_t	position;			///< Current position of the page.
+	uint64_t	free_blocks;		///< Number of free blocks counted by the page.
+	uint64_t	max_blocks;			///< Maximum number of blocks.
+	uint64_t	min_block_size;		///< Minimum block size (Power Two pages).
+	uint64_t	max_block_size;		///< Maximum block size (Power Two pages).
+};
+
+/**
+* @struct rtsha_snapshot_block
+* @brief Block header record.
+*/
+struct rtsha_snapshot_block
+{
+	uint32_t	offset;				///< Offset of the block header relative to the page start position.
+	uint32_t	size;				///< Size of the block including the header. The lowest two bits hold RTSHA_SNAPSHOT_BLOCK_FREE and RTSHA_SNAPSHOT_BLOCK_LAST.
+};
+
+/**
+* @struct rtsha_snapshot_page_summary
+* @brief Summary of the page free structures written after the page blocks.
+*/
+struct rtsha_snapshot_page_summary
+{
+	uint32_t	flags;				///< RTSHA_SNAPSHOT_PAGE_INCONSISTENT, RTSHA_SNAPSHOT_PAGE_NO_BLOCKS
+	uint32_t	reserved;			///< Reserved, always 0.
+	uint64_t	number_blocks;		///< Number of blocks of the page.
+	uint64_t	used_bytes;			///< Sum of the sizes of all allocated blocks.
+	uint64_t	free_bytes;			///< Sum of the sizes of all free blocks.
+	uint64_t	largest_free_block;	///< Size of the largest free block.
+	uint64_t	free_index_entries;	///< Number of entries in the free list, free list array or free map of the page.
+};
+
+/** @} */ // end of RTSHA_SNAPSHOT group
+
+/**
+ * @brief A function pointer type for writing snapshot data.
+ *
+ * @param data Pointer to the data to be written.
+ * @param size Number of bytes to write.
+ * @param context User context.
+ * @return True on success, false to stop the snapshot.
+ */
+typedef bool (*rtshSnapshotWritePtr)(const void* data, size_t size, void* context);
@@ -39,20 +39,30 @@ namespace rtsha
 	*
 	* This structure provides the necessary attributes to manage a memory block,
 	* including its size and reference to a previous block.
+	* With RTSHA_COMPACT_BLOCK_HEADER the size and the reference are 32 bits wide and
+	* the previous block is stored as its distance from this block.
 	*/
 	struct rtsha_block
 	{
 		/// @brief Default constructor for the block, initializing it to default values.
 		rtsha_block()
 			:size(0U)
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+			,prev_offset(0U)
+#else
 			,prev(nullptr)
+#endif
 		{
 		}
 
-		size_t					   size;	///< Size of the block. Aligned size with the last two bits 
+		RTSHA_BLOCK_FIELD_TYPE	   size;	///< Size of the block. Aligned size with the last two bits 
 											///< reserved for special flags. Bit 0 indicates free status,
 											///< and bit 1 indicates if it's the last block.
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+		uint32_t			prev_offset;	///< Distance in bytes to the previous block. Zero if there is no previous block.
+#else
 		rtsha_block* prev;					///< Pointer to the previous block.
+#endif
 	};
 
 	/**
@@ -152,7 +162,7 @@ namespace rtsha
 		*/
 		rtsha_attr_inline void clearIsLast() noexcept
 		{
-			_block->size &= ~(1UL << 1U);			
+			_block->size &= ~static_cast<RTSHA_BLOCK_FIELD_TYPE>(2U);			
 		}
 
 		/**
@@ -170,7 +180,7 @@ namespace rtsha
 		*/
 		rtsha_attr_inline void* getAllocAddress() const noexcept
 		{
-			return reinterpret_cast<void*>((size_t)_block + 2U * sizeof(size_t));
+			return reinterpret_cast<void*>((size_t)_block + sizeof(rtsha_block));
 		}
 
 		/**
@@ -191,10 +201,14 @@ namespace rtsha
 			if (_block != nullptr)
 			{
 				size_t size = getSize();
-				if ((_block != _block->prev) && (size > sizeof(size_t)))
-				{					
-					size_t* ptrSize2 = reinterpret_cast<size_t*>((size_t)_block + size - sizeof(size_t));
+				if ((_block != getPrev()) && (size > sizeof(RTSHA_BLOCK_FIELD_TYPE)))
+				{
+#ifdef RTSHA_NO_BLOCK_FOOTER
+					return true;
+#else
+					RTSHA_BLOCK_FIELD_TYPE* ptrSize2 = reinterpret_cast<RTSHA_BLOCK_FIELD_TYPE*>((size_t)_block + size - RTSHA_BLOCK_FOOTER_SIZE);
 					return (*ptrSize2 == size);
+#endif
 				}
 			}
 			return false;
@@ -206,11 +220,11 @@ namespace rtsha
 		*/
 		rtsha_attr_inline void setSize( size_t size ) noexcept
 		{
-			if (size > sizeof(size_t))
+			if (size > sizeof(RTSHA_BLOCK_FIELD_TYPE))
 			{
 				bool free = isFree();
 				bool last = isLast();
-				_block->size = size;
+				_block->size = static_cast<RTSHA_BLOCK_FIELD_TYPE>(size);
 				if (free)
 				{
 					setFree();
@@ -219,8 +233,10 @@ namespace rtsha
 				{
 					setLast();
 				}
-				size_t* ptrSize2 = reinterpret_cast<size_t*>((size_t)_block + size - sizeof(size_t));
-				*ptrSize2 = size;
+#ifndef RTSHA_NO_BLOCK_FOOTER
+				RTSHA_BLOCK_FIELD_TYPE* ptrSize2 = reinterpret_cast<RTSHA_BLOCK_FIELD_TYPE*>((size_t)_block + size - RTSHA_BLOCK_FOOTER_SIZE);
+				*ptrSize2 = static_cast<RTSHA_BLOCK_FIELD_TYPE>(size);
+#endif
 			}
 			else
 			{
@@ -234,7 +250,7 @@ namespace rtsha
 		*/
 		rtsha_attr_inline size_t getFreeBlockAddress() const noexcept
 		{
-			return ((size_t)_block + 2U * sizeof(size_t));
+			return ((size_t)_block + sizeof(rtsha_block));
 		}
 
 		/**
@@ -245,20 +261,33 @@ namespace rtsha
 		{
 			if (prev.isValid())
 			{
-				_block->prev = prev.getBlock();
+				setPrevBlock(prev.getBlock());
 			}
 			else
 			{
-				_block->prev = nullptr;
+				setPrevBlock(nullptr);
 			}
 		}
 
+		/**
+		* @brief Sets the previous block for the current block without checking it.
+		* @param prev Pointer to the previous block or nullptr.
+		*/
+		rtsha_attr_inline void setPrevBlock(rtsha_block* prev) noexcept
+		{
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+			_block->prev_offset = (prev != nullptr) ? static_cast<uint32_t>((size_t)_block - (size_t)prev) : 0U;
+#else
+			_block->prev = prev;
+#endif
+		}
+
 		/**
 		* @brief Sets the current block as the first block in a chain.
 		*/
 		rtsha_attr_inline void setAsFirst() noexcept
 		{
-			_block->prev = nullptr;
+			setPrevBlock(nullptr);
 		}
 
 		/**
@@ -290,7 +319,11 @@ namespace rtsha
 		*/
 		rtsha_attr_inline bool hasPrev() noexcept
 		{
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+			return (_block->prev_offset != 0U);
+#else
 			return (_block->prev != nullptr);
+#endif
 		}
 
 		/**
@@ -310,7 +343,11 @@ namespace rtsha
 		*/
 		rtsha_attr_inline rtsha_block* getPrev() const noexcept
 		{
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+			return (_block->prev_offset != 0U) ? reinterpret_cast<rtsha_block*>((size_t)_block - _block->prev_offset) : nullptr;
+#else
 			return _block->prev;
+#endif
 		}
 
 		/**
@@ -318,7 +355,7 @@ namespace rtsha
 		*/
 		rtsha_attr_inline void prepare() noexcept
 		{
-			_block->prev = nullptr;
+			setPrevBlock(nullptr);
 			_block->size = 0;
 		}
 		
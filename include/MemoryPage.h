@@ -43,6 +43,8 @@ namespace rtsha
 	*
 	* This enumeration defines the various page sizes and types within the
 	* memory system. Each entry specifies a distinct page size or category.
+	* A fixed memory page can also use any other block size which is a multiple of RTSHA_ALIGMENT
+	* and not larger than RTSHA_MAX_FIXED_BLOCK_SIZE, e.g. 'static_cast<rtsha_page_size_type>(96U)'.
 	*/
 	enum struct rtsha_page_size_type : uint16_t
 	{
@@ -56,7 +58,11 @@ namespace rtsha
 		PageType512 = 512U,		///< Represents a fixed memory page. All blocks are of the same size, 512 bytes, including the block header data.
 
 		PageTypeBig			= 613U,	///< Represents a 'Big Memory Page'
-		PageTypePowerTwo	= 713U	///< Represents a 'Power Two Memory Page'
+		PageTypePowerTwo	= 713U,	///< Represents a 'Power Two Memory Page'
+		PageTypeTLSF		= 813U,	///< Represents a 'TLSF Memory Page'
+		PageTypePowerTwoBitmap	= 913U,	///< Represents a 'Power Two Memory Page' without block headers
+		PageTypeFixedBitmap		= 1013U,	///< Represents a fixed memory page without block headers
+		PageTypeArena			= 1113U	///< Represents an 'Arena Memory Page' (bump pointer, released at once)
 	};
 	
 	/**
@@ -78,11 +84,16 @@ namespace rtsha
 		
 		uint32_t					flags					= 0U;	///< Flags associated with the page.
 
+		bool						dedicated				= false;	///< The page is owned by an object pool and is never selected by malloc.
+
+		bool						zero_blocks				= false;	///< The blocks taken from the untouched area of the page are set to zero (see rtsha_init_mode::InitZeroPages).
+
 		address_t					start_position			= 0U;	///< Start address of page data.
 		address_t					end_position			= 0U;	///< End address of the page.
 		
 		address_t					position				= 0U;	///< Current position or address within the page.
 		size_t						free_blocks				= 0U;	///< Number of free blocks within the page.
+		size_t						reserved_blocks			= 0U;	///< Number of free blocks reserved by 'Heap::reserve'.
 		
 		rtsha_block*				last_block				= nullptr;	///< Pointer to the last block within the page.
 
@@ -90,7 +101,7 @@ namespace rtsha
 
 		address_t					start_map_data			= 0U;	///< Start address or position of map data for the page.
 		
-		rtsha_page*					map_page				= 0U;	///< Associated map page if any. Used with together with 'Big Memory Page' and 'Power Two Page'.
+		rtsha_page*					map_page				= 0U;	///< Previous page of the same size class, when the class has grown (see Heap::set_page_growth and Heap::rebalance).
 
 		size_t						max_blocks				= 0U;	///< Maximum number of blocks supported by the page.
 
@@ -102,6 +113,48 @@ namespace rtsha
 		rtsha_page*					next					= nullptr; ///< Pointer to the next page similar structure.
 	};
 
+	/**
+	* @struct rtsha_block_info
+	* @brief Describes one block visited by the heap walker.
+	*
+	* The structure is filled on the stack of the walker and passed to the callback.
+	* It stays valid only for the duration of the callback.
+	*/
+	struct rtsha_block_info
+	{
+		address_t					block			= 0U;		///< Address of the block header.
+		address_t					data			= 0U;		///< Address of the block data (the address returned by malloc).
+		size_t						size			= 0U;		///< Size of the block including the block header data.
+		bool						free			= false;	///< True if the block is free.
+		bool						last			= false;	///< True if the block is marked as the last block of the page.
+		rtsha_page_size_type		page_type		= rtsha_page_size_type::PageTypeNotDefined; ///< Type of the page owning the block.
+		rtsha_page*					page			= nullptr;	///< Page owning the block.
+	};
+
+	/**
+	* @brief A function pointer type for the heap walker callback.
+	*
+	* @param info Information about the visited block.
+	* @param context User context passed to the walker.
+	* @return True to continue the walk, false to stop it.
+	*/
+	typedef bool (*rtshWalkBlockPtr)(const rtsha_block_info& info, void* context);
+
+	/**
+	* @struct rtsha_walk_cursor
+	* @brief Holds the position of a bounded heap walk between two calls.
+	*
+	* A default constructed cursor starts the walk at the first block of the first page.
+	*/
+	struct rtsha_walk_cursor
+	{
+		size_t						page_index		= 0U;		///< Index of the page which is walked.
+		address_t					position		= 0U;		///< Address of the next block to be visited. 0 means the start of the page.
+		size_t						visited			= 0U;		///< Total number of visited blocks.
+		bool						finished		= false;	///< True when all pages have been walked or the callback has stopped the walk.
+		bool						inconsistent	= false;	///< True if a page has changed between two steps so that the walk could not be resumed on it.
+	};
+
 	/*! \class MemoryPage
 	* \brief This is a base class representing a page in memory.
 	* It provides various memory handling functions that manipulate MemoryBlock's. 
@@ -154,6 +207,21 @@ namespace rtsha
 		 */
 		void* allocate_block_at_current_pos(const size_t& size)  noexcept;
 
+		/**
+		* @brief Visits the blocks of the page without allocating any memory.
+		*
+		* The walk starts at the block stored in the cursor (or at the first page block when the cursor position is 0)
+		* and visits at most 'max_steps' blocks. The page is locked only while a block header is read,
+		* the callback is always called with the page unlocked.
+		*
+		* @param cursor Walk cursor. The position is updated to the next block, or set to 0 when the page has been walked.
+		* @param max_steps Maximum number of blocks to visit.
+		* @param callback Function called for every visited block.
+		* @param context User context passed to the callback.
+		* @return The number of visited blocks.
+		*/
+		size_t walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept;
+
 		/**
 		* @brief Increments the count of free blocks.
 		*
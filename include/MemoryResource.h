@@ -0,0 +1,219 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <new>
+#include <memory_resource>
+#include "Heap.h"
+
+namespace rtsha
+{
+	using namespace std;
+
+	/**
+	* @class rtsha_resource_base
+	* @brief Common part of the RTSHA 'std::pmr::memory_resource' adapters.
+	*
+	* Alignments up to RTSHA_ALIGMENT are provided by all page types. For a larger alignment the block is allocated
+	* 'alignment' bytes larger and the address of the allocated block is stored in front of the aligned address.
+	*
+	* When the memory can not be allocated 'std::bad_alloc' is thrown if exceptions are enabled, otherwise null pointer is returned.
+	*/
+	class rtsha_resource_base : public std::pmr::memory_resource
+	{
+	protected:
+
+		/**
+		* @brief Constructs the resource for the given heap.
+		* @param heap The heap used by the resource.
+		*/
+		explicit rtsha_resource_base(Heap& heap) noexcept : _heap(heap)
+		{
+		}
+
+		/**
+		* @brief Allocates the block with the resource specific function and aligns it.
+		*
+		* @param allocate Function allocating a block of the given size.
+		* @param bytes The requested size.
+		* @param alignment The requested alignment.
+		* @return Pointer to the aligned block.
+		*/
+		template<class Allocate>
+		void* allocate_aligned(Allocate allocate, size_t bytes, size_t alignment)
+		{
+			if (bytes == 0U)
+			{
+				bytes = 1U;
+			}
+			if (alignment <= RTSHA_ALIGMENT)
+			{
+				return check(allocate(bytes));
+			}
+			void* ptr = check(allocate(bytes + alignment));
+			if (ptr == nullptr)
+			{
+				return nullptr;
+			}
+			/*the block is aligned to RTSHA_ALIGMENT, so there is at least one pointer between the block and the aligned address*/
+			const address_t aligned = rtsha_align(reinterpret_cast<address_t>(ptr) + 1U, alignment);
+			reinterpret_cast<void**>(aligned)[-1] = ptr;
+			return reinterpret_cast<void*>(aligned);
+		}
+
+		/**
+		* @brief Returns the address of the allocated block and the allocated size for an aligned block.
+		*
+		* @param ptr The aligned address.
+		* @param bytes The requested size, it is replaced by the allocated size.
+		* @param alignment The requested alignment.
+		* @return The address of the allocated block.
+		*/
+		static void* allocated_block(void* ptr, size_t& bytes, size_t alignment) noexcept
+		{
+			if (bytes == 0U)
+			{
+				bytes = 1U;
+			}
+			if (alignment <= RTSHA_ALIGMENT)
+			{
+				return ptr;
+			}
+			bytes += alignment;
+			return reinterpret_cast<void**>(ptr)[-1];
+		}
+
+		Heap& _heap;	///< The heap used by the resource.
+
+	private:
+
+		/// @brief Reports a failed allocation.
+		static void* check(void* ptr)
+		{
+#if defined(__cpp_exceptions)
+			if (ptr == nullptr)
+			{
+				throw std::bad_alloc();
+			}
+#endif
+			return ptr;
+		}
+	};
+
+	/**
+	* @class heap_resource
+	* @brief 'std::pmr::memory_resource' allocating on a RTSHA heap.
+	*
+	* The page is selected by the heap, as for malloc. The known size of the released block is used to find the page of a
+	* 'Small Fixed Memory Page' block directly, see 'Heap::free_sized'.
+	*/
+	class heap_resource : public rtsha_resource_base
+	{
+	public:
+
+		/**
+		* @brief Constructs the resource for the given heap.
+		* @param heap The heap used by the resource.
+		*/
+		explicit heap_resource(Heap& heap) noexcept : rtsha_resource_base(heap)
+		{
+		}
+
+	protected:
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			return allocate_aligned([this](size_t size) noexcept { return _heap.malloc(size); }, bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			if (ptr != nullptr)
+			{
+				void* block = allocated_block(ptr, bytes, alignment);
+				_heap.free_sized(block, bytes);
+			}
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			/*no RTTI is needed, the resources are compared by identity*/
+			return (this == &other);
+		}
+	};
+
+	/**
+	* @class page_resource
+	* @brief 'std::pmr::memory_resource' allocating on a single page of a RTSHA heap.
+	*
+	* The blocks are allocated and released on the page without page selection (see 'Heap::page_malloc' and 'Heap::page_free').
+	* Any page type can be used, including the dedicated pages of object pools and arenas.
+	*/
+	class page_resource : public rtsha_resource_base
+	{
+	public:
+
+		/**
+		* @brief Constructs the resource for the given page.
+		* @param heap The heap owning the page.
+		* @param page The page used by the resource.
+		*/
+		page_resource(Heap& heap, rtsha_page* page) noexcept : rtsha_resource_base(heap), _page(page)
+		{
+		}
+
+		/** @brief Returns the page of the resource. */
+		rtsha_attr_inline rtsha_page* page() const noexcept
+		{
+			return _page;
+		}
+
+	protected:
+
+		void* do_allocate(size_t bytes, size_t alignment) override
+		{
+			return allocate_aligned([this](size_t size) noexcept { return _heap.page_malloc(_page, size); }, bytes, alignment);
+		}
+
+		void do_deallocate(void* ptr, size_t bytes, size_t alignment) override
+		{
+			if (ptr != nullptr)
+			{
+				_heap.page_free(_page, allocated_block(ptr, bytes, alignment));
+			}
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+		{
+			return (this == &other);
+		}
+
+	private:
+		rtsha_page* _page;	///< The page used by the resource.
+	};
+}
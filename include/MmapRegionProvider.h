@@ -0,0 +1,69 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include "RegionProvider.h"
+
+/** @defgroup RTSHA_MMAP_OPTIONS RTSHA Virtual Memory Options
+ *  @brief Options of the region provider based on the virtual memory of the operating system.
+ *  @{
+ */
+
+/** @brief The region is backed by huge pages. Explicit huge pages ('MAP_HUGETLB') are used when the system has them, otherwise transparent huge pages are requested with 'madvise'. */
+#define RTSHA_MMAP_HUGE_PAGES				(1U)
+
+/** @brief The committed memory is faulted in at once, so the first access to a block does not cause a page fault. */
+#define RTSHA_MMAP_POPULATE					(2U)
+
+/** @brief The committed memory is locked into RAM with 'mlock'. The commit fails when the memory lock limit of the process is too low. */
+#define RTSHA_MMAP_LOCK						(4U)
+
+/** @} */ // end of RTSHA_MMAP_OPTIONS group
+
+namespace rtsha
+{
+	/**
+	* @brief Fills the region provider with functions based on the virtual memory of the operating system.
+	*
+	* The address space is reserved with 'mmap' without access rights and committed with 'mprotect', so only the
+	* committed part of the heap is backed by physical memory.
+	* With 'RTSHA_MMAP_HUGE_PAGES' the granularity of the provider is the huge page size and the reserved region is aligned to it,
+	* so every committed part of the heap consists of whole huge pages.
+	*
+	* @param provider The provider to be filled.
+	* @param options A combination of the RTSHA_MMAP_OPTIONS. The options are stored in the context of the provider.
+	* @return False if virtual memory or one of the options is not supported on the target (no POSIX 'mmap').
+	*/
+	bool rtsha_mmap_region_provider(RegionProviderStruct* provider, uint32_t options = 0U) noexcept;
+
+	/**
+	* @brief Returns the default huge page size of the system.
+	*
+	* @return The huge page size or 0 if huge pages are not supported.
+	*/
+	size_t rtsha_huge_page_size() noexcept;
+}
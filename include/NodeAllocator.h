@@ -0,0 +1,148 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <cstdlib>
+#include <limits>
+#include "Heap.h"
+#include "MemoryBlock.h"
+#include "SmallFixMemoryPage.h"
+
+namespace rtsha
+{
+    /**
+    * @class NodeAllocator
+    * @brief Custom allocator for node based STL containers ('std::list', 'std::forward_list', 'std::map', 'std::set').
+    *
+    * The block size of a node is calculated at compile time from the size of the type. When the container rebinds the
+    * allocator to its node type, the 'Small Fixed Memory Page' of the node size class is taken from the size class table once.
+    * Single nodes are then allocated and released on the free list of this page directly, without page selection.
+    * Arrays (e.g. the buckets of 'std::unordered_map') and nodes which do not fit on the page are allocated with malloc.
+    *
+    * @tparam T The data type the allocator is responsible for.
+    */
+    template<class T>
+    struct NodeAllocator
+    {
+        static_assert(alignof(T) <= RTSHA_ALIGMENT, "The blocks of the fixed size pages are aligned to RTSHA_ALIGMENT.");
+
+        /**
+        * @brief Defines the type of elements managed by the allocator.
+        */
+        typedef T value_type;
+
+        /// @brief The size of a block holding one object of type T, including the block header.
+        static constexpr size_t BLOCK_SIZE = ((sizeof(rtsha_block) + sizeof(T) + RTSHA_BLOCK_FOOTER_SIZE + RTSHA_ALIGMENT - 1U) / RTSHA_ALIGMENT) * RTSHA_ALIGMENT;
+
+        /**
+        * @brief Constructs the allocator for the given heap.
+        *
+        * @param heap The heap on which the objects are allocated.
+        */
+        explicit NodeAllocator(Heap& heap) noexcept
+            : _heap(&heap), _page(heap.select_fixed_page(BLOCK_SIZE))
+        {
+        }
+
+        /**
+        * @brief Copy constructor allowing for type conversion. The page is selected for the new type.
+        *
+        * @tparam U The data type of the other allocator.
+        * @param rhs The other allocator to be copied from.
+        */
+        template<class U>
+        NodeAllocator(const NodeAllocator <U>& rhs) noexcept
+            : _heap(rhs._heap), _page(rhs._heap->select_fixed_page(BLOCK_SIZE))
+        {
+        }
+
+        /**
+        * @brief Allocates a memory for an array of `n` objects of type `T`.
+        *
+        * @param n Number of objects to allocate memory for.
+        * @return Pointer to the allocated block of memory or null pointer if the allocation fails.
+        */
+        [[nodiscard]] rtsha_attr_inline T* allocate(std::size_t n) noexcept
+        {
+            if ((n == 1U) && (_page != nullptr))
+            {
+                SmallFixMemoryPage memory_page(_page);
+                if (auto p = static_cast<T*>(memory_page.allocate_block(static_cast<size_t>(_page->flags))))
+                {
+                    return p;
+                }
+            }
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(_heap->malloc(n * sizeof(T)));
+        }
+
+        /**
+        * @brief Deallocates memory. A single node allocated on the page of the size class is returned to the free list of the page.
+        *
+        * @param p Pointer to the memory to be deallocated.
+        * @param n Number of objects originally requested during allocation.
+        */
+        rtsha_attr_inline void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (p == nullptr)
+            {
+                return;
+            }
+            const address_t address = reinterpret_cast<address_t>(p);
+            if ((n == 1U) && (_page != nullptr) && (address >= _page->start_position) && (address < _page->end_position))
+            {
+                MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block)));
+                SmallFixMemoryPage memory_page(_page);
+                memory_page.free_block(block);
+                return;
+            }
+            _heap->free(p);
+        }
+
+        Heap*           _heap;      ///< The heap on which the objects are allocated.
+        rtsha_page*     _page;      ///< The page of the size class of T or null pointer if there is no such page.
+    };
+
+    /**
+     * @brief Compares two `NodeAllocator` objects for equality.
+     *
+     * @return True if both allocators use the same heap, the memory allocated by one can be released by the other.
+     */
+    template<class T, class U>
+    bool operator==(const NodeAllocator <T>& lhs, const NodeAllocator <U>& rhs) noexcept { return lhs._heap == rhs._heap; }
+
+    /**
+    * @brief Compares two `NodeAllocator` objects for inequality.
+    *
+    * @return True if the allocators use different heaps.
+    */
+    template<class T, class U>
+    bool operator!=(const NodeAllocator <T>& lhs, const NodeAllocator <U>& rhs) noexcept { return lhs._heap != rhs._heap; }
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include <new>
+#include <utility>
+#include "Heap.h"
+#include "MemoryBlock.h"
+#include "SmallFixMemoryPage.h"
+
+namespace rtsha
+{
+	using namespace std;
+
+	/**
+	* @class ObjectPool
+	* @brief Typed pool of objects on a dedicated 'Small Fixed Memory Page'.
+	*
+	* The block size of the page is calculated at compile time from the size of the type. The page is not used by malloc,
+	* so the objects of one type stay together in memory. The objects are created and destroyed without page selection
+	* and without size calculation: the block is taken from and returned to the known page directly.
+	*
+	* The objects can also be released with Heap::free, the destructor is not called in that case.
+	*
+	* @tparam T The type of the objects.
+	*/
+	template<class T>
+	class ObjectPool
+	{
+		static_assert(alignof(T) <= RTSHA_ALIGMENT, "The blocks of the page are aligned to RTSHA_ALIGMENT.");
+
+		/// @brief The free list node is stored in the data area of a free block.
+		static constexpr size_t FREE_NODE_SIZE = 3U * sizeof(size_t);
+
+		/// @brief The size of the object or of the free list node, whichever is larger.
+		static constexpr size_t DATA_SIZE = (sizeof(T) > FREE_NODE_SIZE) ? sizeof(T) : FREE_NODE_SIZE;
+
+	public:
+
+		/// @brief The size of every block of the page including the block header.
+		static constexpr size_t BLOCK_SIZE = ((sizeof(rtsha_block) + DATA_SIZE + RTSHA_BLOCK_FOOTER_SIZE + RTSHA_ALIGMENT - 1U) / RTSHA_ALIGMENT) * RTSHA_ALIGMENT;
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		ObjectPool() = delete;
+
+		ObjectPool(const ObjectPool&) = delete;
+
+		ObjectPool& operator=(const ObjectPool&) = delete;
+
+		/**
+		* @brief Constructs the pool and adds its page to the heap.
+		*
+		* @param heap The heap on which the page is created.
+		* @param size The size of the page.
+		* @param callbacks The HeapCallbacksStruct with callback functions when used. nullptr if 'callback' functions are not used.
+		*/
+		ObjectPool(Heap& heap, size_t size, HeapCallbacksStruct* callbacks = nullptr) noexcept
+			: _page(heap.add_pool_page(callbacks, size, BLOCK_SIZE))
+		{
+		}
+
+		/// @brief Destructor. The page stays on the heap.
+		~ObjectPool() noexcept
+		{
+		}
+
+		/**
+		* @brief Checks if the page of the pool has been created.
+		*/
+		rtsha_attr_inline bool is_valid() const noexcept
+		{
+			return (_page != nullptr);
+		}
+
+		/**
+		* @brief Returns the page of the pool.
+		*/
+		rtsha_attr_inline rtsha_page* page() const noexcept
+		{
+			return _page;
+		}
+
+		/**
+		* @brief Creates an object on the page of the pool.
+		*
+		* @param args Arguments of the constructor of T.
+		* @return Pointer to the object or null pointer if the page is full.
+		*/
+		template<class... Args>
+		T* create(Args&&... args) noexcept
+		{
+			if (_page == nullptr)
+			{
+				return nullptr;
+			}
+			SmallFixMemoryPage memory_page(_page);
+			void* ptr = memory_page.allocate_block(BLOCK_SIZE);
+			if (ptr == nullptr)
+			{
+				return nullptr;
+			}
+			return ::new(ptr) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		* @brief Destroys an object created by the pool and returns its block to the page.
+		*
+		* @param object Pointer returned by create. Null pointer is ignored.
+		*/
+		void destroy(T* object) noexcept
+		{
+			if ((object == nullptr) || (_page == nullptr))
+			{
+				return;
+			}
+			object->~T();
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(reinterpret_cast<address_t>(object) - sizeof(rtsha_block)));
+			SmallFixMemoryPage memory_page(_page);
+			memory_page.free_block(block);
+		}
+
+	private:
+		rtsha_page* _page;	///< The dedicated page of the pool.
+	};
+}
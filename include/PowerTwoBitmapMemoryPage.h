@@ -0,0 +1,107 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+
+
+namespace rtsha
+{
+	using namespace std;
+
+	/**
+	* @class PowerTwoBitmapMemoryPage
+	* @brief This class provides memory handling functions for the 'Power Two Bitmap Memory Page'
+	*
+	* The page is a binary buddy allocator without block headers. The order and the free state of every block are kept
+	* in a compact bitmap at the page head ('FreeBuddyBitmap'), so a request of 2^n bytes gets exactly a block of 2^n bytes.
+	* Released blocks are merged with their buddies up to the order of the top blocks.
+	*
+	* The memory blocks of this page do not contain the 'rtsha_block' header. The 'MemoryBlock' objects passed to and
+	* returned by the page refer to the data address of the block.
+	*/
+	class PowerTwoBitmapMemoryPage : public MemoryPage
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		PowerTwoBitmapMemoryPage() = delete;
+
+		/**
+		* @brief Constructor that initializes the PowerTwoBitmapMemoryPage with a given page.
+		* @param page The rtsha_page structure to initialize the PowerTwoBitmapMemoryPage with.
+		*/
+		explicit PowerTwoBitmapMemoryPage(rtsha_page* page) : MemoryPage(page)
+		{
+		}
+
+		/// @brief Virtual destructor for the PowerTwoBitmapMemoryPage.
+		virtual ~PowerTwoBitmapMemoryPage()
+		{
+		}
+
+		/*! \fn allocate_block(size_t size)
+		* \brief Allocates a block of memory of the specified size.
+		*
+		* \param size The requested number of bytes. The size is rounded up to the next power of two, no header is added.
+		*
+		* \return On success, a pointer to the memory block allocated by the function.
+		*/
+		virtual void* allocate_block(const size_t& size) noexcept final;
+
+		/**
+		* @brief Frees the specified memory block and merges it with its free buddies.
+		* @param block The memory block to be freed. The block refers to the data address.
+		*/
+		virtual void free_block(MemoryBlock& block) noexcept final;
+
+		/**
+		* @brief Returns the size of an allocated block.
+		* @param address The data address of the block.
+		* @return The size of the block or 0 if the address is not an allocated block of the page.
+		*/
+		size_t usable_size(address_t address) noexcept;
+
+		/**
+		* @brief Visits the blocks of the page. The blocks are found using the bitmaps.
+		*
+		* @param cursor Walk cursor. The position is updated to the next block, or set to 0 when the page has been walked.
+		* @param max_steps Maximum number of blocks to visit.
+		* @param callback Function called for every visited block.
+		* @param context User context passed to the callback.
+		* @return The number of visited blocks.
+		*/
+		size_t walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept;
+
+		/**
+		* @brief Inserts all top blocks of the page into the free lists.
+		*/
+		void createInitialFreeBlocks() noexcept;
+	};
+}
@@ -34,6 +34,9 @@ namespace rtsha
 {
 	using namespace std;
 
+	/// @brief The minimal size of a free block on a 'Power Two Memory Page': block header, free list node (three words) and the size copy at the end of the block.
+	constexpr size_t POWER_TWO_MIN_FREE_BLOCK_SIZE = sizeof(rtsha_block) + 3U * sizeof(size_t) + RTSHA_BLOCK_FOOTER_SIZE;
+
 	/*! \class PowerTwoMemoryPage
 	* \brief This class provides various memory handling functions that manipulate MemoryBlock's on 'Power two memory page'
 	*
@@ -49,8 +52,8 @@ namespace rtsha
 	The coalescing operation helps ensure that large contiguous blocks of memory can be reformed after they are freed, reducing 
 	the likelihood of fragmentation over time.
 
-	Coalescing relies on having free blocks of the same size available, which is not always the case, and so this system does not
-	completely eliminate fragmentation but rather aims to minimize it.
+	A released block is merged with its buddy, found by address arithmetic (the offset of the block relative to the page start XOR its size).
+	The merging is repeated with the buddy of the merged block until the buddy is in use or has been split.
 	*/
 	class PowerTwoMemoryPage : public MemoryPage
 	{
@@ -90,6 +93,15 @@ namespace rtsha
 		*/
 		virtual void free_block(MemoryBlock& block) noexcept final;
 
+		/*! \fn free_split_block(MemoryBlock& block)
+		* \brief This function deallocates memory block without merging it with its buddy.
+		*
+		* The block stays split, so the next allocation of its size is taken from the free list without splitting a larger block.
+		*
+		* \param block Previously allocated memory block.
+		*/
+		void free_split_block(MemoryBlock& block) noexcept;
+
 		/*! \fn createInitialFreeBlocks()
 		* \brief This function creates initial free blocks on empty memory page.
 		*
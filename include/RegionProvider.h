@@ -0,0 +1,77 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief A function pointer type for reserving address space of the heap.
+ *
+ * @param size The number of bytes to reserve.
+ * @param context The user context of the provider.
+ * @return The start of the reserved region or null pointer if the region can not be reserved.
+ */
+typedef void* (*rtshReserveRegionPtr)	(size_t size, void* context);
+
+/**
+ * @brief A function pointer type for committing a part of the reserved region, so that it can be used.
+ *
+ * The committed memory must be filled with zeros.
+ *
+ * @param address The start of the part, aligned to the granularity of the provider.
+ * @param size The size of the part, a multiple of the granularity of the provider.
+ * @param context The user context of the provider.
+ * @return True if the memory has been committed.
+ */
+typedef bool (*rtshCommitRegionPtr)		(void* address, size_t size, void* context);
+
+/**
+ * @brief A function pointer type for releasing the whole reserved region.
+ *
+ * @param address The start of the region returned by the reserve function.
+ * @param size The reserved size.
+ * @param context The user context of the provider.
+ */
+typedef void (*rtshReleaseRegionPtr)	(void* address, size_t size, void* context);
+
+/**
+ * @struct RegionProviderStruct
+ * @brief Upstream provider of the heap memory.
+ *
+ * The heap reserves the address space for its hard cap once and commits it on demand, when pages are added
+ * and the committed part of the heap is used up. The heap stays one contiguous region.
+ */
+typedef struct RegionProviderStruct
+{
+	rtshReserveRegionPtr	ptrReserveFunction;		///< Function to reserve the address space.
+	rtshCommitRegionPtr		ptrCommitFunction;		///< Function to commit a part of the reserved region.
+	rtshReleaseRegionPtr	ptrReleaseFunction;		///< Function to release the reserved region. It can be null pointer.
+	size_t					granularity;			///< Granularity of the commit function (e.g. the size of a virtual memory page), a power of two.
+	void*					context;				///< User context passed to the functions.
+} RegionProvider;
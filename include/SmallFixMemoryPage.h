@@ -93,5 +93,81 @@ namespace rtsha
 		* \param block Previously allocated memory block.
 		*/
 		virtual void free_block(MemoryBlock& block) noexcept final;
+
+		/*! \fn allocate_reserved_block()
+		* \brief Allocates one of the blocks reserved with 'reserve_blocks'.
+		*
+		* \return On success, a pointer to the memory block or null pointer if no reserved block is left.
+		*/
+		void* allocate_reserved_block() noexcept;
+
+		/*! \fn free_reserved_block(MemoryBlock& block)
+		* \brief This function deallocates memory block and returns it to the reserved blocks.
+		*
+		* \param block Memory block allocated by 'allocate_reserved_block'.
+		*/
+		void free_reserved_block(MemoryBlock& block) noexcept;
+
+		/*! \fn reserve_blocks(size_t count)
+		* \brief Reserves free blocks, they are taken only by 'allocate_reserved_block'.
+		*
+		* \param count The number of blocks.
+		*
+		* \return False if the page has less than 'count' blocks which are not reserved.
+		*/
+		bool reserve_blocks(size_t count) noexcept;
+
+		/*! \fn release_reserved_blocks(size_t count)
+		* \brief Returns reserved blocks to the blocks available for 'allocate_block'.
+		*
+		* \param count The number of blocks.
+		*/
+		void release_reserved_blocks(size_t count) noexcept;
+
+		/*! \fn available_blocks()
+		* \brief Returns the number of blocks which can be allocated: the free blocks and the blocks of the untouched area of the page.
+		*/
+		rtsha_attr_inline size_t available_blocks() const noexcept
+		{
+			/*the position must stay below the end of the page*/
+			const size_t untouched = (_page->end_position > _page->position) ? ((_page->end_position - _page->position - 1U) / static_cast<size_t>(_page->flags)) : 0U;
+			return _page->free_blocks + untouched;
+		}
+
+		/*! \fn prepare_free_blocks(size_t count)
+		* \brief Takes blocks from the untouched area of the page and puts them to the free list until it holds 'count' blocks.
+		*
+		* The data of the blocks is written, so the memory is faulted in.
+		*
+		* \param count The number of free blocks.
+		*
+		* \return False if the page is too small.
+		*/
+		bool prepare_free_blocks(size_t count) noexcept;
+
+		/*! \fn release_unused(const size_t& size)
+		* \brief Removes a range from the end of the untouched area of the page.
+		*
+		* The untouched area lies between the current position and the end of the page; no block has been allocated in it.
+		*
+		* \param size Size of the range, aligned.
+		*
+		* \return Start address of the released range or 0 if the untouched area is too small.
+		*/
+		address_t release_unused(const size_t& size) noexcept;
+
+		using MemoryPage::walk;
+
+	private:
+
+		/*! \fn take_block(const size_t& size)
+		* \brief Takes a block from the free list or from the untouched area. The page must be locked.
+		*/
+		void* take_block(const size_t& size) noexcept;
+
+		/*! \fn put_block(MemoryBlock& block)
+		* \brief Puts a block to the free list. The page must be locked.
+		*/
+		void put_block(MemoryBlock& block) noexcept;
 	};
 }
@@ -0,0 +1,86 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include "MemoryPage.h"
+
+
+namespace rtsha
+{
+	using namespace std;
+
+	/**
+	* @class TLSFMemoryPage
+	* @brief This class provides various memory handling functions that manipulate MemoryBlock's on 'TLSF memory page'
+	*
+	* The page uses the 'Two Level Segregated Fit' algorithm. Free blocks of variable size are kept in segregated lists
+	* indexed by two bitmaps, so that the allocation and the release of a block are O(1) operations.
+	* Released blocks are immediately merged with their free neighbours using the block headers ('boundary tags').
+	*/
+	class TLSFMemoryPage : public MemoryPage
+	{
+	public:
+
+		/// @brief Default constructor is deleted to prevent default instantiation.
+		TLSFMemoryPage() = delete;
+
+		/**
+		* @brief Constructor that initializes the TLSFMemoryPage with a given page.
+		* @param page The rtsha_page structure to initialize the TLSFMemoryPage with.
+		*/
+		explicit TLSFMemoryPage(rtsha_page* page) : MemoryPage(page)
+		{
+		}
+
+		/// @brief Virtual destructor for the TLSFMemoryPage.
+		virtual ~TLSFMemoryPage()
+		{
+		}
+
+		/*! \fn allocate_block(size_t size)
+		* \brief Allocates a block of memory of the specified size.
+		*
+		* \param size The size of the memory block to allocate, including the block header data.
+		*
+		* \return On success, a pointer to the memory block allocated by the function.
+		*/
+		virtual void* allocate_block(const size_t& size) noexcept final;
+
+		/**
+		* @brief Frees the specified memory block and merges it with its free neighbours.
+		* @param block The memory block to be freed.
+		*/
+		virtual void free_block(MemoryBlock& block) noexcept final;
+
+		/**
+		* @brief Creates the initial free block and the internal last block of the page.
+		*/
+		void createInitialFreeBlocks() noexcept;
+	};
+}
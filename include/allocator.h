@@ -68,6 +68,9 @@ SOFTWARE.
 #define RTSHA_PAGE_TYPE_512			512U
 #define RTSHA_PAGE_TYPE_BIG			613U
 #define RTSHA_PAGE_TYPE_POWER_TWO	713U
+#define RTSHA_PAGE_TYPE_TLSF		813U
+#define RTSHA_PAGE_TYPE_POWER_TWO_BITMAP	913U
+#define RTSHA_PAGE_TYPE_FIXED_BITMAP		1013U
 
 
 
@@ -91,6 +94,10 @@ extern "C"
 
 	rtsha_decl_export						void* rtsha_memset(void* _Dst, int _Val, size_t _Size);
 
+	rtsha_decl_export						size_t rtsha_snapshot(void* buffer, size_t size);
+
+	rtsha_decl_export						size_t rtsha_coalesce(size_t budget);
+
 #ifdef __cplusplus
 }
 #endif
@@ -32,4 +32,6 @@ SOFTWARE.
 #include <stddef.h>
 
 void* arm_wide64_memcpy(void* dst, const void* src, size_t n);
+
+void* arm_wide64_memset(void* dst, int value, size_t n);
 #endif
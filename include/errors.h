@@ -71,5 +71,8 @@ SOFTWARE.
 /** @brief Error code indicating that the block i too small or too big for selected page. */
 #define RTSHA_BlockSizeNotAllowed		(512U)
 
+/** @brief Error code indicating that the buffer is too small for the heap snapshot. */
+#define RTSHA_SnapshotBufferTooSmall		(1024U)
+
 /** @} */ // end of RTSHA_ERRORS group
 
@@ -76,7 +76,21 @@ Note: This algorithm is primarily designed for test purposes, especially for sys
 The "Big Memory Pages" algorithm employs the "Best Fit" strategy, which is complemented by a "Red-Black" balanced tree. The Red-Black tree ensures worst-case guarantees for insertion, deletion, and search times, making it predictable in performance. A key distinction between this system and the "Power Two Memory Page" is in how they handle memory blocks. Unlike the latter, "Big Memory Pages" does not restrict memory to be partitioned exclusively into power-of-two sizes. Instead, variable block sizes are allowed, providing more flexibility. Additionally, once memory blocks greater than 512 bytes are released, they are promptly merged or coalesced, optimizing the memory usage.
 Despite its features, it's essential to understand the specific use-cases and limitations of this algorithm and to choose the most suitable one based on the system's requirements and constraints.
 
-The use of 'Small Fixed Memory Pages' in combination with 'Power Two Memory Pages' is recommended for all real time systems.
+4. TLSF Memory Pages
+The "TLSF Memory Pages" algorithm uses the "Two Level Segregated Fit" strategy for blocks of variable size. The free blocks are kept in segregated free lists, indexed by two bitmaps. The first level divides the block sizes into power-of-two classes and the second level divides every class linearly.
+Allocation and deallocation are O(1) operations. The lists are linked through the free blocks and released blocks are immediately merged with their free neighbours.
+
+5. Power Two Bitmap Memory Pages
+A buddy allocator for power-of-two blocks without block headers. The order and the free state of every block are kept in two bitmaps at the page head, so a request of 2^n bytes occupies exactly 2^n bytes. Released blocks are merged with their buddies up to the maximal block size.
+
+6. Fixed Bitmap Memory Pages
+A fixed block size page without block headers. The slot of a block is found from its address and the allocation state of every slot is kept in a bitmap at the page head. A free slot is found with a 'count trailing zeros' instruction and a released block is marked free by clearing a single bit, which also detects a double free.
+
+7. Arena Memory Pages
+A bump pointer page for short living objects. An allocation only advances the current position of the page, the blocks have no headers and are not released one by one.
+The whole page is released at once by resetting the position, and nested scopes are released by rewinding the position to a marker.
+
+The use of 'Small Fixed Memory Pages' in combination with 'Power Two Memory Pages' or 'TLSF Memory Pages' is recommended for all real time systems.
 */
 
 
@@ -88,11 +102,19 @@ The use of 'Small Fixed Memory Pages' in combination with 'Power Two Memory Page
 #define MAX_SMALL_PAGES			32U
 #define MAX_BIG_PAGES			2U
 #define MAX_POWER_TWO_PAGES		2U
+#define MAX_TLSF_PAGES			2U
+#define MAX_POWER_TWO_BITMAP_PAGES	2U
+#define MAX_FIXED_BITMAP_PAGES	8U
+#define MAX_ARENA_PAGES			8U
 
-#define MAX_PAGES				(MAX_SMALL_PAGES+MAX_BIG_PAGES+MAX_POWER_TWO_PAGES)
+#define MAX_PAGES				(MAX_SMALL_PAGES+MAX_BIG_PAGES+MAX_POWER_TWO_PAGES+MAX_TLSF_PAGES+MAX_POWER_TWO_BITMAP_PAGES+MAX_FIXED_BITMAP_PAGES+MAX_ARENA_PAGES)
 
 #define MAX_BINS 27U
 
+#define RTSHA_MAX_FIXED_BLOCK_SIZE	4096U /*the largest block size of a 'Small Fix Memory Page'*/
+
+#define DEFERRED_SCAN_LIMIT		8U /*deferred blocks checked by 'Big Memory Page' allocation before the free map is searched*/
+
 #if (__MSC_VER >= 1930 )
 #define rtsha_attr_inline inline __forceinline
 #else
@@ -124,12 +146,32 @@ The use of 'Small Fixed Memory Pages' in combination with 'Power Two Memory Page
 
 #if defined _WIN64 || defined _ARM64
 #define RTSHA_BLOCK_HEADER_SIZE  (2 * sizeof(size_t))
-#define MIN_BLOCK_SIZE_FOR_SPLIT	56U /*todo*/
+#define MIN_BLOCK_SIZE_FOR_SPLIT	64U /*block header, free map node and size copy*/
 #else
 #define RTSHA_LIST_ITEM_SIZE  (2 * sizeof(size_t))
 #define MIN_BLOCK_SIZE_FOR_SPLIT	512U /*todo*/
 #endif
 
+/*
+* RTSHA_COMPACT_BLOCK_HEADER: the block header contains a 32-bit size and a 32-bit offset to the previous block,
+* so the header takes 8 bytes instead of 16 bytes on 64-bit targets. Every page must be smaller than 4 GB.
+* RTSHA_NO_BLOCK_FOOTER: the copy of the size at the end of every block is not used. The block overhead is smaller,
+* but a corrupted block header can not be detected.
+*/
+#ifdef RTSHA_COMPACT_BLOCK_HEADER
+#define RTSHA_BLOCK_FIELD_TYPE		uint32_t
+#define RTSHA_MAX_PAGE_SIZE			(static_cast<size_t>(UINT32_MAX))
+#else
+#define RTSHA_BLOCK_FIELD_TYPE		size_t
+#define RTSHA_MAX_PAGE_SIZE			(SIZE_MAX)
+#endif
+
+#ifdef RTSHA_NO_BLOCK_FOOTER
+#define RTSHA_BLOCK_FOOTER_SIZE		0U
+#else
+#define RTSHA_BLOCK_FOOTER_SIZE		sizeof(RTSHA_BLOCK_FIELD_TYPE)	/*copy of the block size at the end of the block*/
+#endif
+
 #ifdef __cplusplus
 #if (__cplusplus >= 201103L) || (_MSC_VER >= 1930)
 #define rtsha_attr_noexcept   noexcept
@@ -156,6 +198,8 @@ The use of 'Small Fixed Memory Pages' in combination with 'Power Two Memory Page
 
 #define RTSHA_ALIGMENT			sizeof(size_t)	/*4U or 8U*/
 
+#define RTSHA_SIZE_CLASSES		(RTSHA_MAX_FIXED_BLOCK_SIZE / RTSHA_ALIGMENT) /*entries of the size class table, one per aligned size*/
+
 #define is_bit(val,n) ( (val >> n) & 0x01U )
 
 #ifndef rtsha_assert
@@ -237,6 +281,65 @@ namespace internal
 #endif
 
 
+    /**
+    * @brief Returns the index of the least significant set bit.
+    *
+    * @param value Value to be scanned. Must not be 0.
+    * @return Index of the least significant set bit.
+    */
+    rtsha_attr_inline uint32_t rtsha_ffs(uint32_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, value);
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+    }
+
+    /**
+    * @brief Returns the index of the least significant set bit of a word.
+    *
+    * @param value Value to be scanned. Must not be 0.
+    * @return Index of the least significant set bit.
+    */
+    rtsha_attr_inline uint32_t rtsha_ctz(size_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#if defined(_WIN64)
+        _BitScanForward64(&index, value);
+#else
+        _BitScanForward(&index, value);
+#endif
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(__builtin_ctzll(static_cast<unsigned long long>(value)));
+#endif
+    }
+
+    /**
+    * @brief Returns the index of the most significant set bit.
+    *
+    * @param value Value to be scanned. Must not be 0.
+    * @return Index of the most significant set bit.
+    */
+    rtsha_attr_inline uint32_t rtsha_fls(size_t value) noexcept
+    {
+#ifdef _MSC_VER
+        unsigned long index;
+#if defined(_WIN64)
+        _BitScanReverse64(&index, value);
+#else
+        _BitScanReverse(&index, value);
+#endif
+        return static_cast<uint32_t>(index);
+#else
+        return static_cast<uint32_t>(63 - __builtin_clzll(static_cast<unsigned long long>(value)));
+#endif
+    }
+
     /**
     * @brief Memory storage template for pre-allocation.
     *
@@ -296,6 +399,14 @@ namespace internal
             }
             return nullptr;
         }
+
+        /**
+        * @brief Retrieves the number of the memory blocks which are still available.
+        */
+        rtsha_attr_inline size_t available() const noexcept
+        {
+            return (n - _count);
+        }
     private:
         uint8_t _memory[n * sizeof(T)]; ///< Pre-allocated memory storage.
         size_t _count = 0U;             ///< Counter for used blocks in the storage.
@@ -0,0 +1,89 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+namespace internal
+{
+	/**
+	* @brief Copies memory with the widest kernel of the target.
+	*
+	* The kernel is selected at build time (NEON on AArch64, 64-bit transfers on Cortex-M7) or, on x86-64, at run time
+	* (AVX2 when the processor and the operating system support it, SSE2 otherwise). The destination is aligned to the
+	* vector size by the prologue, the epilogue stores the last vector unaligned. The memory areas must not overlap.
+	*
+	* @param dst The destination.
+	* @param src The source.
+	* @param size The number of bytes.
+	* @return The destination.
+	*/
+	void* rtsha_copy(void* dst, const void* src, size_t size) noexcept;
+
+	/**
+	* @brief Fills memory with a byte value with the widest kernel of the target, see 'rtsha_copy'.
+	*
+	* @param dst The destination.
+	* @param value The value, converted to 'uint8_t'.
+	* @param size The number of bytes.
+	* @return The destination.
+	*/
+	void* rtsha_fill(void* dst, int value, size_t size) noexcept;
+
+	/**
+	* @brief Copies memory with non-temporal stores, see 'rtsha_copy'.
+	*
+	* The destination lines are written around the caches ('movntdq' on x86-64, 'STNP' on AArch64), so a large copy
+	* does not evict the working set of other tasks. Copies shorter than a few cache lines use 'rtsha_copy'.
+	* Targets without non-temporal stores use 'rtsha_copy'.
+	*
+	* @param dst The destination.
+	* @param src The source.
+	* @param size The number of bytes.
+	* @return The destination.
+	*/
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept;
+
+	/**
+	* @brief Fills memory with non-temporal stores, see 'rtsha_copy_stream'.
+	*
+	* On AArch64 a zero fill uses 'DC ZVA' for the whole blocks of the range when the instruction is permitted.
+	*
+	* @param dst The destination.
+	* @param value The value, converted to 'uint8_t'.
+	* @param size The number of bytes.
+	* @return The destination.
+	*/
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept;
+
+	/**
+	* @brief Returns the name of the selected kernel, e.g. "AVX2".
+	*/
+	const char* rtsha_kernel_name() noexcept;
+}
@@ -0,0 +1,146 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#include "ArenaMemoryPage.h"
+#include "internal.h"
+#include "errors.h"
+
+namespace rtsha
+{
+	using namespace internal;
+
+	void* ArenaMemoryPage::allocate_block(const size_t& size) noexcept
+	{
+		return allocate_aligned(size, RTSHA_ALIGMENT);
+	}
+
+	void* ArenaMemoryPage::allocate_aligned(size_t size, size_t alignment) noexcept
+	{
+		RTSHA_EXPECTS(_page);
+		if ((0U == size) || (0U == alignment) || (0U != (alignment & (alignment - 1U))))
+		{
+			return nullptr;
+		}
+
+		this->lock();
+		const address_t address = rtsha_align(this->getPosition(), alignment);
+		if ((address < this->getPosition()) || (address > _page->end_position) || (size > (_page->end_position - address)))
+		{
+			this->unlock();
+			this->reportError(RTSHA_OutOfMemory);
+			return nullptr;
+		}
+		this->setPosition(address + size);
+		this->unlock();
+		return reinterpret_cast<void*>(address);
+	}
+
+	void ArenaMemoryPage::free_block(MemoryBlock& block) noexcept
+	{
+		/*the blocks are released by reset or rewind*/
+		(void)block;
+	}
+
+	address_t ArenaMemoryPage::marker() noexcept
+	{
+		return this->getPosition();
+	}
+
+	bool ArenaMemoryPage::rewind(address_t marker) noexcept
+	{
+		bool ret = false;
+		this->lock();
+		if ((marker >= _page->start_position) && (marker <= this->getPosition()))
+		{
+			this->setPosition(marker);
+			ret = true;
+		}
+		this->unlock();
+		return ret;
+	}
+
+	void ArenaMemoryPage::reset() noexcept
+	{
+		this->setPosition(_page->start_position);
+	}
+
+	size_t ArenaMemoryPage::walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		size_t steps = 0U;
+		address_t address = cursor.position;
+		if (0U == address)
+		{
+			address = _page->start_position;
+		}
+
+		while (steps < max_steps)
+		{
+			rtsha_block_info info;
+
+			this->lock();
+			const address_t position = this->getPosition();
+			if (address >= _page->end_position)
+			{
+				/*the whole page has been walked*/
+				this->unlock();
+				address = 0U;
+				break;
+			}
+			if (address > position)
+			{
+				/*the page has been rewound since the last step*/
+				this->unlock();
+				cursor.inconsistent = true;
+				address = 0U;
+				break;
+			}
+			/*the allocated area first, then the rest of the page*/
+			const bool used = (address < position);
+			const address_t end = used ? position : _page->end_position;
+			info.block		= address;
+			info.data		= address;
+			info.size		= end - address;
+			info.free		= !used;
+			info.last		= (end == _page->end_position);
+			info.page_type	= this->getPageType();
+			info.page		= _page;
+			this->unlock();
+
+			address = end;
+			steps++;
+			cursor.visited++;
+
+			if ((callback != nullptr) && (false == callback(info, context)))
+			{
+				cursor.finished = true;
+				break;
+			}
+		}
+		cursor.position = address;
+		return steps;
+	}
+}
@@ -36,6 +36,8 @@ namespace rtsha
 {
 	using namespace internal;
 
+	static_assert(MIN_BLOCK_SIZE_FOR_SPLIT >= FREE_MAP_MIN_BLOCK_SIZE, "The rest of a split block must be large enough for the map node.");
+
 	void* BigMemoryPage::allocate_block(const size_t& size) noexcept
 	{
 		void* ret(nullptr);
@@ -44,13 +46,92 @@ namespace rtsha
 		{
 			return nullptr;
 		}
+		/*a free block must be large enough for the tree node*/
+		size_t a_size = (size < FREE_MAP_MIN_BLOCK_SIZE) ? FREE_MAP_MIN_BLOCK_SIZE : size;
+
+		this->lock();
+
+		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
+		if (ptrMap->deferred_size() > 0U)
+		{
+			/*reuse a deferred block of the same size first*/
+			size_t address = ptrMap->take_deferred(static_cast<uint64_t>(a_size), DEFERRED_SCAN_LIMIT);
+			if (address != 0U)
+			{
+				MemoryBlock block(reinterpret_cast<rtsha_block*>((void*)address));
+				block.setAllocated();
+				this->unlock();
+				return block.getAllocAddress();
+			}
+		}
+
+		ret = this->allocateFromMap(a_size);
+		if ((nullptr == ret) && (ptrMap->deferred_size() > 0U))
+		{
+			/*the request can not be satisfied, coalesce all deferred blocks and try again*/
+			this->coalesceDeferred(ptrMap->deferred_size());
+			ret = this->allocateFromMap(a_size);
+		}
+		this->unlock();
+		return ret;
+	}
 
+	void BigMemoryPage::free_block(MemoryBlock& block) noexcept
+	{
 		this->lock();
 
+		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
+	
+		/*set as free*/
+		block.setFree();
+						
+		if (this->isLastPageBlock(block))
+		{
+			/*it should never happen -  the last 64B internal block can not be free*/
+			assert(false);
+			this->unlock();
+			return;
+		}
+
+		if (ptrMap->is_deferred())
+		{
+			/*the block will be merged later by 'coalesce' or by an allocation which can not be satisfied*/
+			ptrMap->defer(reinterpret_cast<size_t>(block.getBlock()));
+		}
+		else
+		{
+			this->releaseBlock(block);
+		}
+		this->unlock();
+	}
+
+	size_t BigMemoryPage::coalesce(size_t budget) noexcept
+	{
+		this->lock();
+		size_t ret = this->coalesceDeferred(budget);
+		this->unlock();
+		return ret;
+	}
+
+	void BigMemoryPage::set_deferred(bool enable) noexcept
+	{
+		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
+		this->lock();
+		ptrMap->set_deferred(enable);
+		if (!enable)
+		{
+			(void)this->coalesceDeferred(ptrMap->deferred_size());
+		}
+		this->unlock();
+	}
+
+	void* BigMemoryPage::allocateFromMap(size_t a_size) noexcept
+	{
+		void* ret(nullptr);
 		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
 		if ((this->getFreeBlocks() > 0U) || (ptrMap->size() > 0U))
 		{
-			size_t address = ptrMap->find(static_cast<const uint64_t>(size));			
+			size_t address = ptrMap->find(static_cast<uint64_t>(a_size));			
 			if (address != 0U)
 			{
 				MemoryBlock block(reinterpret_cast<rtsha_block*>((void*)address));
@@ -60,31 +141,28 @@ namespace rtsha
 				{
 					assert(false);
 					this->reportError(RTSHA_InvalidBlock);
-					this->unlock();
 					return ret;
 				}
 
-				if (block.isValid() && (orig_size >= size))
+				if (block.isValid() && (orig_size >= a_size))
 				{
 					/*delete used block from the map of free blocks*/
-					const uint64_t k = static_cast<const uint64_t>(orig_size);
-					if (ptrMap->del(k, reinterpret_cast<size_t>(block.getBlock())))
+					if (ptrMap->del(reinterpret_cast<size_t>(block.getBlock())))
 					{
 						/*decrease the number of free blocks*/
 						this->decFreeBlocks();
 					}
 					
-					size_t diff = orig_size - size;
+					size_t diff = orig_size - a_size;
 					if (diff >= (MIN_BLOCK_SIZE_FOR_SPLIT ))
 					{						
-						this->splitBlock(block, size);
+						this->splitBlock(block, a_size);
 					}
 
 					if (!block.isValid())
 					{
 						assert(false);
 						this->reportError(RTSHA_InvalidBlock);
-						this->unlock();
 						return ret;						
 					}										
 					/*set block as allocated*/
@@ -93,85 +171,68 @@ namespace rtsha
 				}
 			}
 		}
-		this->unlock();
 		return ret;
 	}
 
-	void BigMemoryPage::free_block(MemoryBlock& block) noexcept
+	size_t BigMemoryPage::coalesceDeferred(size_t budget) noexcept
 	{
-		this->lock();
-
 		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
-	
-		/*set as free*/
-		block.setFree();
-						
-		if (this->isLastPageBlock(block))
+		size_t count = 0U;
+		while (count < budget)
 		{
-			/*it should never happen -  the last 64B internal block can not be free*/
-			assert(false);
-			this->unlock();
-			return;
-		}
-		
-		bool merged(false);
-		/*merging loop left*/
-		while (block.hasPrev() && (this->getFreeBlocks() > 0U))
-		{			
-			MemoryBlock prev(block.getPrev());
-	
-			if ( prev.isValid() && prev.isFree() && (prev.getSize() > 0U))
-			{
-				/*merge two blocks*/
-				mergeLeft(block);
-				merged = true;				
-				break;
-			}
-			else
+			size_t address = ptrMap->pop_deferred();
+			if (address == 0U)
 			{
 				break;
 			}
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(address));
+			this->releaseBlock(block);
+			count++;
 		}
-		/*merging loop right*/
-		while (!block.isLast() && !this->isLastPageBlock(block) && (this->getFreeBlocks() > 0U))
-		{			
-			MemoryBlock next(block.getNextBlock());
+		return count;
+	}
 
+	void BigMemoryPage::releaseBlock(MemoryBlock& block) noexcept
+	{
+		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
+
+		/*the free neighbours are removed from the map (or from the list of deferred blocks), merged and the result is inserted once*/
+		/*merge with the right neighbour*/
+		if (!block.isLast() && !this->isLastPageBlock(block))
+		{
+			MemoryBlock next(block.getNextBlock());
 			if (next.isValid() && next.isFree() && !next.isLast() && next.hasPrev() && (next.getPrev() == block.getBlock()))
 			{
-				/*merge two blocks*/
-				//mergeRight(block);
-				merged = true;
-				break;
-			}
-			else
-			{
-				break;
+				mergeRight(block);
 			}
 		}
-		if ( ptrMap->size() != this->getFreeBlocks() )
+
+		/*merge with the left neighbour*/
+		if (block.hasPrev())
 		{
-			assert(false);
-			this->reportError(RTSHA_InvalidNumberOfFreeBlocks);
+			MemoryBlock prev(block.getPrev());
+			if (prev.isValid() && prev.isFree() && (prev.getSize() > 0U))
+			{
+				mergeLeft(block);
+			}
 		}
 
 		if (block.isValid())
-		{					
-			if (!merged)
-			{
-				if (false == ptrMap->exists(static_cast<const uint64_t>(block.getSize()), reinterpret_cast<size_t>(block.getBlock())))
-				{
-					ptrMap->insert(static_cast<const uint64_t>(block.getSize()), reinterpret_cast<size_t>(block.getBlock()));
-					this->incFreeBlocks();
-				}
-			}
+		{
+			ptrMap->insert(static_cast<uint64_t>(block.getSize()), reinterpret_cast<size_t>(block.getBlock()));
+			this->incFreeBlocks();
 		}
 		else
 		{
 			assert(false);
 			this->reportError(RTSHA_InvalidBlock);
 		}
-		this->unlock();
+
+		if ( ptrMap->size() != this->getFreeBlocks() )
+		{
+			assert(false);
+			this->reportError(RTSHA_InvalidNumberOfFreeBlocks);
+		}
 	}
 
 	void BigMemoryPage::splitBlock(MemoryBlock& block, size_t size)  noexcept
@@ -204,25 +265,8 @@ namespace rtsha
 
 		if (prev.isFree())
 		{			
-			FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
-			if (ptrMap->del( static_cast<const uint64_t>(prev.getSize()), reinterpret_cast<size_t>(prev.getBlock()) ) )
-			{
-				/*decrease the number of free blocks*/
-				this->decFreeBlocks();	
-			}
-	
+			removeFreeBlock(prev);
 			block.merge_left();
-			
-			if (block.isValid()) 
-			{				
-				ptrMap->insert(static_cast<const uint64_t>(block.getSize()), reinterpret_cast<size_t>(block.getBlock()));
-				this->incFreeBlocks();
-			}
-			else
-			{
-				assert(false);
-				this->reportError(RTSHA_InvalidBlock);
-			}
 		}
 	}
 
@@ -231,24 +275,26 @@ namespace rtsha
 		MemoryBlock next(block.getNextBlock());
 		if (next.isValid() && next.isFree())
 		{
-			FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
-			if (ptrMap->del(static_cast<const uint64_t>(next.getSize()), reinterpret_cast<size_t>(next.getBlock())))
-			{
-				/*decrease the number of free blocks*/
-				this->decFreeBlocks();
-			}
+			removeFreeBlock(next);
 			block.merge_right();
+			/*destroy old header*/
+			next.prepare();
+		}
+	}
 
-			if (block.isValid())
-			{
-				ptrMap->insert(static_cast<const uint64_t>(block.getSize()), reinterpret_cast<size_t>(block.getBlock()));
-				this->incFreeBlocks();
-			}
-			else
-			{
-				assert(false);
-				this->reportError(RTSHA_InvalidBlock);
-			}
+	void BigMemoryPage::removeFreeBlock(MemoryBlock& block) noexcept
+	{
+		FreeMap* ptrMap = reinterpret_cast<FreeMap*>(this->getFreeMap());
+		if (ptrMap->del(reinterpret_cast<size_t>(block.getBlock())))
+		{
+			/*decrease the number of free blocks*/
+			this->decFreeBlocks();
+		}
+		else if (!ptrMap->undefer(reinterpret_cast<size_t>(block.getBlock())))
+		{
+			/*a free block must be in the map or in the list of deferred blocks*/
+			assert(false);
+			this->reportError(RTSHA_InvalidNumberOfFreeBlocks);
 		}
 	}
 
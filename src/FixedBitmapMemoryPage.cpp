@@ -0,0 +1,137 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#include "FixedBitmapMemoryPage.h"
+#include "FreeSlotBitmap.h"
+#include "internal.h"
+#include "errors.h"
+
+namespace rtsha
+{
+	using namespace internal;
+
+	void* FixedBitmapMemoryPage::allocate_block(const size_t& size) noexcept
+	{
+		RTSHA_EXPECTS(_page);
+		if (0U == size)
+		{
+			return nullptr;
+		}
+
+		FreeSlotBitmap* ptrIndex = reinterpret_cast<FreeSlotBitmap*>(this->getFreeMap());
+		if (size > ptrIndex->block_size())
+		{
+			this->reportError(RTSHA_BlockSizeNotAllowed);
+			return nullptr;
+		}
+
+		this->lock();
+		address_t address = ptrIndex->pop();
+		if (address != 0U)
+		{
+			this->decFreeBlocks();
+		}
+		this->unlock();
+		return reinterpret_cast<void*>(address);
+	}
+
+	void FixedBitmapMemoryPage::free_block(MemoryBlock& block) noexcept
+	{
+		FreeSlotBitmap* ptrIndex = reinterpret_cast<FreeSlotBitmap*>(this->getFreeMap());
+
+		this->lock();
+		if (ptrIndex->release(reinterpret_cast<address_t>(block.getBlock())))
+		{
+			this->incFreeBlocks();
+		}
+		else
+		{
+			/*not the start of a block or the block is already free*/
+			this->reportError(RTSHA_InvalidBlock);
+		}
+		this->unlock();
+	}
+
+	size_t FixedBitmapMemoryPage::usable_size(address_t address) noexcept
+	{
+		FreeSlotBitmap* ptrIndex = reinterpret_cast<FreeSlotBitmap*>(this->getFreeMap());
+		size_t ret = 0U;
+		this->lock();
+		if (ptrIndex->is_allocated(address))
+		{
+			ret = ptrIndex->block_size();
+		}
+		this->unlock();
+		return ret;
+	}
+
+	size_t FixedBitmapMemoryPage::walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		FreeSlotBitmap* ptrIndex = reinterpret_cast<FreeSlotBitmap*>(this->getFreeMap());
+		const size_t size = ptrIndex->block_size();
+		size_t steps = 0U;
+		address_t address = cursor.position;
+		if (0U == address)
+		{
+			address = ptrIndex->base();
+		}
+
+		while (steps < max_steps)
+		{
+			rtsha_block_info info;
+
+			if (address >= ptrIndex->end())
+			{
+				/*the whole page has been walked*/
+				address = 0U;
+				break;
+			}
+
+			this->lock();
+			info.block		= address;
+			info.data		= address;
+			info.size		= size;
+			info.free		= ptrIndex->is_free((address - ptrIndex->base()) / size);
+			info.last		= ((address + size) == ptrIndex->end());
+			info.page_type	= this->getPageType();
+			info.page		= _page;
+			this->unlock();
+
+			address += size;
+			steps++;
+			cursor.visited++;
+
+			if ((callback != nullptr) && (false == callback(info, context)))
+			{
+				cursor.finished = true;
+				break;
+			}
+		}
+		cursor.position = address;
+		return steps;
+	}
+}
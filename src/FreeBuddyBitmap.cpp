@@ -0,0 +1,140 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "FreeBuddyBitmap.h"
+
+namespace internal
+{
+	FreeBuddyBitmap::FreeBuddyBitmap(rtsha_page* page, size_t min_order, size_t max_order, size_t top_blocks, size_t* bitmap, address_t base) noexcept
+		:_page(page), _min_order(min_order), _max_order(max_order), _base(base)
+	{
+		const size_t words = bitmap_words(min_order, max_order, top_blocks);
+		_end = base + (top_blocks << max_order);
+		_free_bits = bitmap;
+		_split_bits = bitmap + (words / 2U);
+		for (size_t i = 0U; i < words; i++)
+		{
+			bitmap[i] = 0U;
+		}
+		for (size_t i = 0U; i <= BUDDY_MAX_ORDER; i++)
+		{
+			_lists[i] = nullptr;
+		}
+	}
+
+	void FreeBuddyBitmap::insert(address_t block, size_t order) noexcept
+	{
+		rtsha_buddy_links* links = reinterpret_cast<rtsha_buddy_links*>(block);
+		rtsha_buddy_links* head = _lists[order];
+		links->next_free = head;
+		links->prev_free = nullptr;
+		if (head != nullptr)
+		{
+			head->prev_free = links;
+		}
+		_lists[order] = links;
+		_order_map |= (1U << order);
+		set_bit(_free_bits, bit_index(block, order));
+		_count++;
+	}
+
+	void FreeBuddyBitmap::remove(address_t block, size_t order) noexcept
+	{
+		rtsha_buddy_links* links = reinterpret_cast<rtsha_buddy_links*>(block);
+		if (links->next_free != nullptr)
+		{
+			links->next_free->prev_free = links->prev_free;
+		}
+		if (links->prev_free != nullptr)
+		{
+			links->prev_free->next_free = links->next_free;
+		}
+		else
+		{
+			/*the block was the head of the list*/
+			_lists[order] = links->next_free;
+			if (links->next_free == nullptr)
+			{
+				_order_map &= ~(1U << order);
+			}
+		}
+		links->next_free = nullptr;
+		links->prev_free = nullptr;
+		clear_bit(_free_bits, bit_index(block, order));
+		if (_count > 0U)
+		{
+			_count--;
+		}
+	}
+
+	address_t FreeBuddyBitmap::pop(size_t& order) noexcept
+	{
+		if (order > _max_order)
+		{
+			return 0U;
+		}
+		uint32_t map = _order_map & (~0U << order);
+		if (0U == map)
+		{
+			return 0U;
+		}
+		order = rtsha_ffs(map);
+		address_t block = reinterpret_cast<address_t>(_lists[order]);
+		remove(block, order);
+		return block;
+	}
+
+	size_t FreeBuddyBitmap::order_of(address_t block) const noexcept
+	{
+		if (!contains(block))
+		{
+			return 0U;
+		}
+		const size_t offset = block - _base;
+		size_t order = _min_order;
+		while (order < _max_order)
+		{
+			if (0U != (offset & ((static_cast<size_t>(1U) << order) - 1U)))
+			{
+				/*the address is not aligned to the order, it points into a block*/
+				return 0U;
+			}
+			if (test_bit(_split_bits, bit_index(block, order + 1U)))
+			{
+				/*the parent has been split, the block is a whole node of this order*/
+				return order;
+			}
+			order++;
+		}
+		if (0U != (offset & ((static_cast<size_t>(1U) << order) - 1U)))
+		{
+			return 0U;
+		}
+		return order;
+	}
+}
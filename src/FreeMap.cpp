@@ -25,6 +25,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 ******************************************************************************/
 
+
 #include "FreeMap.h"
 
 namespace internal
@@ -32,8 +33,462 @@ namespace internal
 	FreeMap::FreeMap(rtsha_page* page) noexcept
 		:_page(page)
 	{
-		/*create objects on stack using new in place*/		
-		_mallocator = new (_storage_allocator.get_ptr())	mmap_allocator(page);
-		_ptrMap		= new (_storage_map.get_ptr())			mmap(*_mallocator);
+	}
+
+	void FreeMap::insert(const uint64_t key, size_t block) noexcept
+	{
+		rtsha_free_map_node* node = node_of(block);
+		rtsha_free_map_node* parent_node = nullptr;
+		rtsha_free_map_node* current = _root;
+		bool left = false;
+
+		node->left = nullptr;
+		node->right = nullptr;
+		node->next_dup = nullptr;
+		node->prev_dup = nullptr;
+
+		while (current != nullptr)
+		{
+			uint64_t current_key = key_of(current);
+			if (key == current_key)
+			{
+				/*the size is already in the tree, add the block to the list of the tree node*/
+				node->parent_color = LINKED;
+				node->prev_dup = current;
+				node->next_dup = current->next_dup;
+				if (current->next_dup != nullptr)
+				{
+					current->next_dup->prev_dup = node;
+				}
+				current->next_dup = node;
+				_count++;
+				return;
+			}
+			parent_node = current;
+			left = (key < current_key);
+			current = left ? current->left : current->right;
+		}
+
+		node->parent_color = reinterpret_cast<uintptr_t>(parent_node) | LINKED;
+		set_red(node);
+
+		if (parent_node == nullptr)
+		{
+			_root = node;
+		}
+		else if (left)
+		{
+			parent_node->left = node;
+		}
+		else
+		{
+			parent_node->right = node;
+		}
+		insert_fixup(node);
+		_count++;
+	}
+
+	bool FreeMap::del(size_t block) noexcept
+	{
+		rtsha_free_map_node* node = node_of(block);
+		if (!is_linked(node))
+		{
+			return false;
+		}
+
+		if (node->prev_dup != nullptr)
+		{
+			/*the block is in the list of the blocks of the same size*/
+			node->prev_dup->next_dup = node->next_dup;
+			if (node->next_dup != nullptr)
+			{
+				node->next_dup->prev_dup = node->prev_dup;
+			}
+		}
+		else if (node->next_dup != nullptr)
+		{
+			/*the next block of the same size takes the place of the tree node*/
+			rtsha_free_map_node* dup = node->next_dup;
+			dup->parent_color = node->parent_color;
+			replace(node, dup);
+			dup->left = node->left;
+			dup->right = node->right;
+			if (dup->left != nullptr)
+			{
+				set_parent(dup->left, dup);
+			}
+			if (dup->right != nullptr)
+			{
+				set_parent(dup->right, dup);
+			}
+			dup->prev_dup = nullptr;
+		}
+		else
+		{
+			erase(node);
+		}
+
+		node->left = nullptr;
+		node->right = nullptr;
+		node->parent_color = 0U;
+		node->next_dup = nullptr;
+		node->prev_dup = nullptr;
+		_count--;
+		return true;
+	}
+
+	size_t FreeMap::find(const uint64_t key) noexcept
+	{
+		/*lower bound - the leftmost node which is not smaller than the key*/
+		rtsha_free_map_node* best = nullptr;
+		rtsha_free_map_node* current = _root;
+		while (current != nullptr)
+		{
+			if (key_of(current) >= key)
+			{
+				best = current;
+				current = current->left;
+			}
+			else
+			{
+				current = current->right;
+			}
+		}
+		if (best == nullptr)
+		{
+			return 0U;
+		}
+		/*prefer a block from the list, it is removed without changing the tree*/
+		return (best->next_dup != nullptr) ? block_of(best->next_dup) : block_of(best);
+	}
+
+	bool FreeMap::exists(size_t block) noexcept
+	{
+		return is_linked(node_of(block));
+	}
+
+	bool FreeMap::is_linked(const rtsha_free_map_node* node) const noexcept
+	{
+		if (0U == (node->parent_color & LINKED))
+		{
+			return false;
+		}
+		if (node->prev_dup != nullptr)
+		{
+			return (node->prev_dup->next_dup == node);
+		}
+		rtsha_free_map_node* parent_node = parent(node);
+		if (parent_node == nullptr)
+		{
+			return (_root == node);
+		}
+		return ((parent_node->left == node) || (parent_node->right == node));
+	}
+
+	void FreeMap::defer(size_t block) noexcept
+	{
+		rtsha_free_map_node* node = node_of(block);
+		/*the parent is not used, the value can not be taken for a node linked in the tree*/
+		node->left = nullptr;
+		node->right = nullptr;
+		node->parent_color = DEFERRED;
+		node->prev_dup = nullptr;
+		node->next_dup = _deferred;
+		if (_deferred != nullptr)
+		{
+			_deferred->prev_dup = node;
+		}
+		_deferred = node;
+		_deferred_count++;
+	}
+
+	bool FreeMap::undefer(size_t block) noexcept
+	{
+		rtsha_free_map_node* node = node_of(block);
+		if (node->parent_color != DEFERRED)
+		{
+			return false;
+		}
+		if ((node->prev_dup != nullptr) ? (node->prev_dup->next_dup != node) : (_deferred != node))
+		{
+			return false;
+		}
+		unlink_deferred(node);
+		return true;
+	}
+
+	size_t FreeMap::take_deferred(const uint64_t key, size_t max_scan) noexcept
+	{
+		rtsha_free_map_node* node = _deferred;
+		while ((node != nullptr) && (max_scan > 0U))
+		{
+			uint64_t node_key = key_of(node);
+			if ((node_key >= key) && ((node_key - key) < MIN_BLOCK_SIZE_FOR_SPLIT))
+			{
+				unlink_deferred(node);
+				return block_of(node);
+			}
+			node = node->next_dup;
+			max_scan--;
+		}
+		return 0U;
+	}
+
+	size_t FreeMap::pop_deferred() noexcept
+	{
+		rtsha_free_map_node* node = _deferred;
+		if (node == nullptr)
+		{
+			return 0U;
+		}
+		unlink_deferred(node);
+		return block_of(node);
+	}
+
+	void FreeMap::unlink_deferred(rtsha_free_map_node* node) noexcept
+	{
+		if (node->prev_dup != nullptr)
+		{
+			node->prev_dup->next_dup = node->next_dup;
+		}
+		else
+		{
+			_deferred = node->next_dup;
+		}
+		if (node->next_dup != nullptr)
+		{
+			node->next_dup->prev_dup = node->prev_dup;
+		}
+		node->parent_color = 0U;
+		node->next_dup = nullptr;
+		node->prev_dup = nullptr;
+		_deferred_count--;
+	}
+
+	void FreeMap::rotate_left(rtsha_free_map_node* node) noexcept
+	{
+		rtsha_free_map_node* right = node->right;
+		node->right = right->left;
+		if (right->left != nullptr)
+		{
+			set_parent(right->left, node);
+		}
+		replace(node, right);
+		right->left = node;
+		set_parent(node, right);
+	}
+
+	void FreeMap::rotate_right(rtsha_free_map_node* node) noexcept
+	{
+		rtsha_free_map_node* left = node->left;
+		node->left = left->right;
+		if (left->right != nullptr)
+		{
+			set_parent(left->right, node);
+		}
+		replace(node, left);
+		left->right = node;
+		set_parent(node, left);
+	}
+
+	void FreeMap::replace(rtsha_free_map_node* node, rtsha_free_map_node* with) noexcept
+	{
+		rtsha_free_map_node* parent_node = parent(node);
+		if (parent_node == nullptr)
+		{
+			_root = with;
+		}
+		else if (node == parent_node->left)
+		{
+			parent_node->left = with;
+		}
+		else
+		{
+			parent_node->right = with;
+		}
+		if (with != nullptr)
+		{
+			set_parent(with, parent_node);
+		}
+	}
+
+	void FreeMap::insert_fixup(rtsha_free_map_node* node) noexcept
+	{
+		rtsha_free_map_node* parent_node = parent(node);
+		while (is_red(parent_node))
+		{
+			rtsha_free_map_node* grandparent = parent(parent_node);
+			if (parent_node == grandparent->left)
+			{
+				rtsha_free_map_node* uncle = grandparent->right;
+				if (is_red(uncle))
+				{
+					set_black(parent_node);
+					set_black(uncle);
+					set_red(grandparent);
+					node = grandparent;
+				}
+				else
+				{
+					if (node == parent_node->right)
+					{
+						node = parent_node;
+						rotate_left(node);
+						parent_node = parent(node);
+					}
+					set_black(parent_node);
+					set_red(grandparent);
+					rotate_right(grandparent);
+				}
+			}
+			else
+			{
+				rtsha_free_map_node* uncle = grandparent->left;
+				if (is_red(uncle))
+				{
+					set_black(parent_node);
+					set_black(uncle);
+					set_red(grandparent);
+					node = grandparent;
+				}
+				else
+				{
+					if (node == parent_node->left)
+					{
+						node = parent_node;
+						rotate_right(node);
+						parent_node = parent(node);
+					}
+					set_black(parent_node);
+					set_red(grandparent);
+					rotate_left(grandparent);
+				}
+			}
+			parent_node = parent(node);
+		}
+		set_black(_root);
+	}
+
+	void FreeMap::erase(rtsha_free_map_node* node) noexcept
+	{
+		rtsha_free_map_node* child;
+		rtsha_free_map_node* child_parent;
+		bool removed_red = is_red(node);
+
+		if (node->left == nullptr)
+		{
+			child = node->right;
+			child_parent = parent(node);
+			replace(node, node->right);
+		}
+		else if (node->right == nullptr)
+		{
+			child = node->left;
+			child_parent = parent(node);
+			replace(node, node->left);
+		}
+		else
+		{
+			/*the successor takes the place of the node*/
+			rtsha_free_map_node* successor = node->right;
+			while (successor->left != nullptr)
+			{
+				successor = successor->left;
+			}
+			removed_red = is_red(successor);
+			child = successor->right;
+			if (parent(successor) == node)
+			{
+				child_parent = successor;
+			}
+			else
+			{
+				child_parent = parent(successor);
+				replace(successor, successor->right);
+				successor->right = node->right;
+				set_parent(successor->right, successor);
+			}
+			replace(node, successor);
+			successor->left = node->left;
+			set_parent(successor->left, successor);
+			successor->parent_color = (successor->parent_color & ~static_cast<uintptr_t>(1U)) | (node->parent_color & 1U);
+		}
+
+		if (!removed_red)
+		{
+			erase_fixup(child, child_parent);
+		}
+	}
+
+	void FreeMap::erase_fixup(rtsha_free_map_node* node, rtsha_free_map_node* parent_node) noexcept
+	{
+		while ((node != _root) && !is_red(node))
+		{
+			if (node == parent_node->left)
+			{
+				rtsha_free_map_node* sibling = parent_node->right;
+				if (is_red(sibling))
+				{
+					set_black(sibling);
+					set_red(parent_node);
+					rotate_left(parent_node);
+					sibling = parent_node->right;
+				}
+				if (!is_red(sibling->left) && !is_red(sibling->right))
+				{
+					set_red(sibling);
+					node = parent_node;
+					parent_node = parent(node);
+				}
+				else
+				{
+					if (!is_red(sibling->right))
+					{
+						set_black(sibling->left);
+						set_red(sibling);
+						rotate_right(sibling);
+						sibling = parent_node->right;
+					}
+					sibling->parent_color = (sibling->parent_color & ~static_cast<uintptr_t>(1U)) | (parent_node->parent_color & 1U);
+					set_black(parent_node);
+					set_black(sibling->right);
+					rotate_left(parent_node);
+					node = _root;
+				}
+			}
+			else
+			{
+				rtsha_free_map_node* sibling = parent_node->left;
+				if (is_red(sibling))
+				{
+					set_black(sibling);
+					set_red(parent_node);
+					rotate_right(parent_node);
+					sibling = parent_node->left;
+				}
+				if (!is_red(sibling->left) && !is_red(sibling->right))
+				{
+					set_red(sibling);
+					node = parent_node;
+					parent_node = parent(node);
+				}
+				else
+				{
+					if (!is_red(sibling->left))
+					{
+						set_black(sibling->right);
+						set_red(sibling);
+						rotate_left(sibling);
+						sibling = parent_node->left;
+					}
+					sibling->parent_color = (sibling->parent_color & ~static_cast<uintptr_t>(1U)) | (parent_node->parent_color & 1U);
+					set_black(parent_node);
+					set_black(sibling->left);
+					rotate_right(parent_node);
+					node = _root;
+				}
+			}
+		}
+		set_black(node);
 	}
 }
@@ -0,0 +1,111 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#include "FreeSlotBitmap.h"
+
+namespace internal
+{
+	FreeSlotBitmap::FreeSlotBitmap(rtsha_page* page, size_t block_size, size_t slots, size_t* bitmap, address_t base) noexcept
+		:_page(page), _block_size(block_size), _slots(slots), _base(base)
+	{
+		_words = (slots + SLOT_BITS_PER_WORD - 1U) / SLOT_BITS_PER_WORD;
+		_end = base + (slots * block_size);
+		_free_bits = bitmap;
+		_word_bits = bitmap + _words;
+
+		/*all slots are free, the bits behind the last slot stay cleared*/
+		for (size_t i = 0U; i < _words; i++)
+		{
+			const size_t rest = slots - (i * SLOT_BITS_PER_WORD);
+			_free_bits[i] = (rest >= SLOT_BITS_PER_WORD) ? ~static_cast<size_t>(0U) : ((static_cast<size_t>(1U) << rest) - 1U);
+		}
+		const size_t summary_words = bitmap_words(slots) - _words;
+		for (size_t i = 0U; i < summary_words; i++)
+		{
+			const size_t rest = _words - (i * SLOT_BITS_PER_WORD);
+			_word_bits[i] = (rest >= SLOT_BITS_PER_WORD) ? ~static_cast<size_t>(0U) : ((static_cast<size_t>(1U) << rest) - 1U);
+		}
+		_count = slots;
+	}
+
+	address_t FreeSlotBitmap::pop() noexcept
+	{
+		if (0U == _count)
+		{
+			return 0U;
+		}
+		const size_t summary_words = bitmap_words(_slots) - _words;
+		for (size_t i = 0U; i < summary_words; i++)
+		{
+			if (_word_bits[i] != 0U)
+			{
+				const size_t word = (i * SLOT_BITS_PER_WORD) + rtsha_ctz(_word_bits[i]);
+				const size_t bit = rtsha_ctz(_free_bits[word]);
+				_free_bits[word] &= ~(static_cast<size_t>(1U) << bit);
+				if (0U == _free_bits[word])
+				{
+					/*no free slot left in the word*/
+					_word_bits[i] &= ~(static_cast<size_t>(1U) << (word % SLOT_BITS_PER_WORD));
+				}
+				_count--;
+				return _base + (((word * SLOT_BITS_PER_WORD) + bit) * _block_size);
+			}
+		}
+		return 0U;
+	}
+
+	bool FreeSlotBitmap::release(address_t block) noexcept
+	{
+		if (!contains(block))
+		{
+			return false;
+		}
+		const size_t offset = block - _base;
+		const size_t slot = offset / _block_size;
+		if (((slot * _block_size) != offset) || is_free(slot))
+		{
+			/*not the start of a slot or a double free*/
+			return false;
+		}
+		const size_t word = slot / SLOT_BITS_PER_WORD;
+		_free_bits[word] |= (static_cast<size_t>(1U) << (slot % SLOT_BITS_PER_WORD));
+		_word_bits[word / SLOT_BITS_PER_WORD] |= (static_cast<size_t>(1U) << (word % SLOT_BITS_PER_WORD));
+		_count++;
+		return true;
+	}
+
+	bool FreeSlotBitmap::is_allocated(address_t block) const noexcept
+	{
+		if (!contains(block))
+		{
+			return false;
+		}
+		const size_t offset = block - _base;
+		const size_t slot = offset / _block_size;
+		return ((slot * _block_size) == offset) && !is_free(slot);
+	}
+}
@@ -0,0 +1,149 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "FreeTLSF.h"
+
+namespace internal
+{
+	FreeTLSF::FreeTLSF(rtsha_page* page) noexcept
+		:_page(page)
+	{
+		for (uint32_t fl = 0U; fl < TLSF_FL_INDEX_COUNT; fl++)
+		{
+			_sl_bitmap[fl] = 0U;
+			for (uint32_t sl = 0U; sl < TLSF_SL_INDEX_COUNT; sl++)
+			{
+				_blocks[fl][sl] = nullptr;
+			}
+		}
+	}
+
+	void FreeTLSF::insert(rtsha_block* block) noexcept
+	{
+		uint32_t fl;
+		uint32_t sl;
+		MemoryBlock mblock(block);
+		mapping_insert(mblock.getSize(), fl, sl);
+
+		rtsha_block* head = _blocks[fl][sl];
+		rtsha_tlsf_links* block_links = links(block);
+		block_links->next_free = head;
+		block_links->prev_free = nullptr;
+		if (head != nullptr)
+		{
+			links(head)->prev_free = block;
+		}
+		_blocks[fl][sl] = block;
+
+		_fl_bitmap |= (1U << fl);
+		_sl_bitmap[fl] |= (1U << sl);
+		_count++;
+	}
+
+	void FreeTLSF::remove(rtsha_block* block) noexcept
+	{
+		uint32_t fl;
+		uint32_t sl;
+		MemoryBlock mblock(block);
+		mapping_insert(mblock.getSize(), fl, sl);
+
+		rtsha_tlsf_links* block_links = links(block);
+		rtsha_block* next = block_links->next_free;
+		rtsha_block* prev = block_links->prev_free;
+		if (next != nullptr)
+		{
+			links(next)->prev_free = prev;
+		}
+		if (prev != nullptr)
+		{
+			links(prev)->next_free = next;
+		}
+		else
+		{
+			/*the block was the head of the list*/
+			_blocks[fl][sl] = next;
+			if (next == nullptr)
+			{
+				_sl_bitmap[fl] &= ~(1U << sl);
+				if (0U == _sl_bitmap[fl])
+				{
+					_fl_bitmap &= ~(1U << fl);
+				}
+			}
+		}
+		block_links->next_free = nullptr;
+		block_links->prev_free = nullptr;
+		if (_count > 0U)
+		{
+			_count--;
+		}
+	}
+
+	rtsha_block* FreeTLSF::pop(size_t size) noexcept
+	{
+		uint32_t fl;
+		uint32_t sl;
+
+		if (size >= TLSF_MAX_BLOCK_SIZE)
+		{
+			return nullptr;
+		}
+		if (size >= TLSF_SMALL_BLOCK_SIZE)
+		{
+			/*round up to the next list, all blocks of that list are large enough*/
+			size += (static_cast<size_t>(1U) << (rtsha_fls(size) - TLSF_SL_INDEX_COUNT_LOG2)) - 1U;
+		}
+		mapping_insert(size, fl, sl);
+		if (fl >= TLSF_FL_INDEX_COUNT)
+		{
+			return nullptr;
+		}
+
+		/*first search the lists of the same class...*/
+		uint32_t sl_map = _sl_bitmap[fl] & (~0U << sl);
+		if (0U == sl_map)
+		{
+			/*...then the first non empty larger class*/
+			uint32_t fl_map = ((fl + 1U) < 32U) ? (_fl_bitmap & (~0U << (fl + 1U))) : 0U;
+			if (0U == fl_map)
+			{
+				return nullptr;
+			}
+			fl = rtsha_ffs(fl_map);
+			sl_map = _sl_bitmap[fl];
+		}
+		sl = rtsha_ffs(sl_map);
+
+		rtsha_block* block = _blocks[fl][sl];
+		if (block != nullptr)
+		{
+			remove(block);
+		}
+		return block;
+	}
+}
@@ -31,23 +31,27 @@ SOFTWARE.
 #include "BigMemoryPage.h"
 #include "SmallFixMemoryPage.h"
 #include "PowerTwoMemoryPage.h"
+#include "TLSFMemoryPage.h"
 #include "HeapCallbacks.h"
 #include "FreeListArray.h"
-
-#ifdef __arm__ //ARM architecture
-#include "arm_spec_functions.h"
-#endif
+#include "FreeTLSF.h"
+#include "FreeBuddyBitmap.h"
+#include "PowerTwoBitmapMemoryPage.h"
+#include "FreeSlotBitmap.h"
+#include "FixedBitmapMemoryPage.h"
+#include "ArenaMemoryPage.h"
+#include "MmapRegionProvider.h"
 
 namespace internal
 {
-	void HeapInternal::init_small_fix_page(rtsha_page* page, size_t a_size) noexcept
+	static_assert(MAX_PAGES < UINT8_MAX, "The size class table holds the page index in 8 bits.");
+
+	void HeapInternal::init_small_fix_page(rtsha_page* page) noexcept
 	{
 		page->start_map_data = 0U;
 		page->map_page = nullptr;
 		page->ptr_list_map = reinterpret_cast<size_t> (static_cast<void*>(createFreeList(page)));
 		page->free_blocks = 0U;
-		_heap_current_position += a_size;
-		page->next = reinterpret_cast<rtsha_page*>(_heap_current_position);
 	}
 
 	void HeapInternal::init_power_two_page(rtsha_page* page, size_t a_size, size_t max_objects, size_t min_block_size, size_t max_block_size) noexcept
@@ -84,6 +88,11 @@ namespace internal
     page->min_block_size = std::max(32U, ExpandToPowerOf2(min_block_size) );
     page->max_block_size = std::max(64U, ExpandToPowerOf2(max_block_size));
 #endif
+		/*the free list node is stored in the free block, it must not overwrite the size copy*/
+		while (page->min_block_size < POWER_TWO_MIN_FREE_BLOCK_SIZE)
+		{
+			page->min_block_size = page->min_block_size << 1U;
+		}
 
 
 		if (max_objects == 0U)
@@ -103,47 +112,163 @@ namespace internal
 
 		PowerTwoMemoryPage mem_page(page);
 		mem_page.createInitialFreeBlocks();
-
-		_heap_current_position += a_size;
-		page->next = reinterpret_cast<rtsha_page*>(_heap_current_position);
 	}
 
 	void HeapInternal::init_big_block_page(rtsha_page* page, size_t a_size, size_t max_objects) noexcept
 	{
-		/*we need additional space for out map data... we can not store data in free blocks... to dangerous...not safe...*/
+		/*the tree of free blocks is stored in the free blocks, no additional map data is needed*/
 		if (max_objects == 0U)
 		{
-			page->max_blocks = ((a_size - sizeof(rtsha_page)) - 2U * INTERNAL_MAP_STORAGE_SIZE - sizeof(rtsha_page)) / (INTERNAL_MAP_STORAGE_SIZE + 512U + sizeof(rtsha_block));
+			page->max_blocks = (a_size - sizeof(rtsha_page)) / FREE_MAP_MIN_BLOCK_SIZE;
 		}
 		else
 		{
 			page->max_blocks = max_objects;
 		}
-		page->start_map_data = (page->end_position - page->max_blocks * (INTERNAL_MAP_STORAGE_SIZE * 2U)); /*fixed blocks 64 bytes on 32 bit platform*/
+		page->start_map_data = 0U;
+		page->map_page = nullptr;
+		page->min_block_size = FREE_MAP_MIN_BLOCK_SIZE;
+		page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeMap(page)));
 
-		page->map_page = reinterpret_cast<rtsha_page*>(page->start_map_data);
+		BigMemoryPage mem_page(page);
+		mem_page.createInitialFreeBlocks();
+	}
 
-		page->map_page->flags = static_cast<uint32_t>(rtsha_page_size_type::PageType64);
-		page->map_page->free_blocks = 0U;
+	void HeapInternal::init_tlsf_page(rtsha_page* page) noexcept
+	{
+		/*the free lists are linked through the free blocks, no additional map data is needed*/
+		page->start_map_data = 0U;
+		page->map_page = nullptr;
+		page->min_block_size = TLSF_MIN_BLOCK_SIZE;
+		page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeTLSF(page)));
+		page->free_blocks = 0U;
 
-		page->map_page->end_position = page->end_position;
+		TLSFMemoryPage mem_page(page);
+		mem_page.createInitialFreeBlocks();
+	}
 
-		page->end_position = page->start_map_data;
+	bool HeapInternal::init_power_two_bitmap_page(rtsha_page* page, size_t min_block_size, size_t max_block_size) noexcept
+	{
+		size_t min_order = (min_block_size > 1U) ? (rtsha_fls(min_block_size - 1U) + 1U) : 0U;
+		size_t max_order = (max_block_size > 1U) ? (rtsha_fls(max_block_size - 1U) + 1U) : 0U;
+		min_order = std::max(min_order, BUDDY_MIN_ORDER);
+		if ((max_order < min_order) || (max_order > BUDDY_MAX_ORDER))
+		{
+			return false;
+		}
 
-		page->map_page->last_block = nullptr;
-		page->map_page->start_map_data = 0U;
-		page->map_page->map_page = nullptr;
-		page->map_page->position = page->start_map_data + sizeof(rtsha_page);
+		/*the bitmaps are stored at the page head, followed by the top blocks*/
+		const size_t top_size = (static_cast<size_t>(1U) << max_order);
+		const size_t data_size = page->end_position - page->start_position;
+		size_t top_blocks = data_size / top_size;
+		address_t base = 0U;
+		while (top_blocks > 0U)
+		{
+			size_t words = FreeBuddyBitmap::bitmap_words(min_order, max_order, top_blocks);
+			base = rtsha_align(page->start_position + (words * sizeof(size_t)), (static_cast<size_t>(1U) << min_order));
+			if ((base + (top_blocks * top_size)) <= page->end_position)
+			{
+				break;
+			}
+			top_blocks--;
+		}
+		if (top_blocks == 0U)
+		{
+			return false;
+		}
 
-		page->map_page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeList(page->map_page)));
-		page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeMap(page)));
+		page->start_map_data = page->start_position;
+		page->map_page = nullptr;
+		page->min_block_size = (static_cast<size_t>(1U) << min_order);
+		page->max_block_size = top_size;
+		page->max_blocks = (top_blocks << (max_order - min_order));
+		page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeBuddyBitmap(page, min_order, max_order, top_blocks, reinterpret_cast<size_t*>(page->start_map_data), base)));
+		page->free_blocks = 0U;
+		page->position = base + (top_blocks * top_size);
 
-		_heap_current_position += a_size;
+		PowerTwoBitmapMemoryPage mem_page(page);
+		mem_page.createInitialFreeBlocks();
+		return true;
+	}
 
-		page->next = reinterpret_cast<rtsha_page*>(_heap_current_position);
+	bool HeapInternal::init_fixed_bitmap_page(rtsha_page* page, size_t block_size) noexcept
+	{
+		block_size = rtsha_align(block_size, RTSHA_ALIGMENT);
+
+		/*the bitmaps are stored at the page head, followed by the blocks*/
+		const size_t data_size = page->end_position - page->start_position;
+		/*every block needs one bit of the slot bitmap, the loop corrects the rounding and the second bitmap*/
+		size_t slots = (data_size * 8U) / ((block_size * 8U) + 1U);
+		address_t base = 0U;
+		while (slots > 0U)
+		{
+			base = page->start_position + (FreeSlotBitmap::bitmap_words(slots) * sizeof(size_t));
+			if ((base + (slots * block_size)) <= page->end_position)
+			{
+				break;
+			}
+			slots--;
+		}
+		if (slots == 0U)
+		{
+			return false;
+		}
 
-		BigMemoryPage mem_page(page);
-		mem_page.createInitialFreeBlocks();
+		page->start_map_data = page->start_position;
+		page->map_page = nullptr;
+		page->min_block_size = block_size;
+		page->max_block_size = block_size;
+		page->max_blocks = slots;
+		page->ptr_list_map = reinterpret_cast<size_t> (reinterpret_cast<void*>(createFreeSlotBitmap(page, block_size, slots, reinterpret_cast<size_t*>(page->start_map_data), base)));
+		page->free_blocks = slots;
+		page->position = base + (slots * block_size);
+		return true;
+	}
+
+	void HeapInternal::init_arena_page(rtsha_page* page) noexcept
+	{
+		page->start_map_data = 0U;
+		page->map_page = nullptr;
+		page->ptr_list_map = 0U;
+		page->free_blocks = 0U;
+		/*only the owner of the page allocates on it*/
+		page->dedicated = true;
+	}
+
+	size_t HeapInternal::walk_page(rtsha_page* page, rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
+		{
+			BigMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo))
+		{
+			PowerTwoMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF))
+		{
+			TLSFMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap))
+		{
+			PowerTwoBitmapMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))
+		{
+			FixedBitmapMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeArena))
+		{
+			ArenaMemoryPage memory_page(page);
+			return memory_page.walk(cursor, max_steps, callback, context);
+		}
+		SmallFixMemoryPage memory_page(page);
+		return memory_page.walk(cursor, max_steps, callback, context);
 	}
 
 	FreeList* HeapInternal::createFreeList(rtsha_page* page) noexcept
@@ -169,6 +294,107 @@ namespace internal
 		RTSHA_EXPECTS(ptrListArray);
 		return new (ptrListArray) FreeListArray(page, page->min_block_size, page_size);
 	}
+
+	FreeTLSF* HeapInternal::createFreeTLSF(rtsha_page* page) noexcept
+	{
+		/*create objects on stack in reserved memory using new in place*/
+		void* ptrIndex = _storage_free_tlsf.get_next_ptr();
+		RTSHA_EXPECTS(ptrIndex);
+		return new (ptrIndex) FreeTLSF(page);
+	}
+
+	FreeBuddyBitmap* HeapInternal::createFreeBuddyBitmap(rtsha_page* page, size_t min_order, size_t max_order, size_t top_blocks, size_t* bitmap, address_t base) noexcept
+	{
+		/*create objects on stack in reserved memory using new in place*/
+		void* ptrIndex = _storage_free_buddy.get_next_ptr();
+		RTSHA_EXPECTS(ptrIndex);
+		return new (ptrIndex) FreeBuddyBitmap(page, min_order, max_order, top_blocks, bitmap, base);
+	}
+
+	void HeapInternal::add_size_class(size_t page_index) noexcept
+	{
+		const size_t block_size = static_cast<size_t>(_pages[page_index]->flags);
+		for (size_t i = 0U; (i < RTSHA_SIZE_CLASSES) && (((i + 1U) * RTSHA_ALIGMENT) <= block_size); i++)
+		{
+			const uint8_t index = _size_classes[i];
+			if ((index == 0U) || (static_cast<size_t>(_pages[index - 1U]->flags) > block_size))
+			{
+				_size_classes[i] = static_cast<uint8_t>(page_index + 1U);
+			}
+		}
+	}
+
+	void HeapInternal::add_bitmap_class(size_t page_index) noexcept
+	{
+		const size_t block_size = _pages[page_index]->max_block_size;
+		for (size_t i = 0U; (i < RTSHA_SIZE_CLASSES) && (((i + 1U) * RTSHA_ALIGMENT) <= block_size); i++)
+		{
+			const uint8_t index = _bitmap_classes[i];
+			if ((index == 0U) || (_pages[index - 1U]->max_block_size > block_size))
+			{
+				_bitmap_classes[i] = static_cast<uint8_t>(page_index + 1U);
+			}
+		}
+		if (block_size > _bitmap_max_block_size)
+		{
+			_bitmap_max_block_size = block_size;
+		}
+	}
+
+	FreeSlotBitmap* HeapInternal::createFreeSlotBitmap(rtsha_page* page, size_t block_size, size_t slots, size_t* bitmap, address_t base) noexcept
+	{
+		/*create objects on stack in reserved memory using new in place*/
+		void* ptrIndex = _storage_free_slots.get_next_ptr();
+		RTSHA_EXPECTS(ptrIndex);
+		return new (ptrIndex) FreeSlotBitmap(page, block_size, slots, bitmap, base);
+	}
+
+	bool HeapInternal::grow_heap(size_t size) noexcept
+	{
+		if ((_provider == nullptr) || (size > (_heap_limit - _heap_current_position)))
+		{
+			return false;
+		}
+		const address_t needed = _heap_current_position + size;
+		if (needed <= _heap_top)
+		{
+			return true;
+		}
+		/*commit whole granules of the provider*/
+		address_t new_top = rtsha_align(needed, _provider->granularity);
+		if (new_top > _heap_limit)
+		{
+			new_top = _heap_limit;
+		}
+		if (!_provider->ptrCommitFunction(reinterpret_cast<void*>(_heap_top), new_top - _heap_top, _provider->context))
+		{
+			return false;
+		}
+		_heap_size += (new_top - _heap_top);
+		_heap_top = new_top;
+		return true;
+	}
+
+	bool HeapInternal::has_page_storage(rtsha_page_size_type size_type) const noexcept
+	{
+		switch (size_type)
+		{
+		case rtsha_page_size_type::PageTypeBig:
+			return (_storage_free_maps.available() > 0U);
+		case rtsha_page_size_type::PageTypePowerTwo:
+			return (_storage_free_list_array.available() > 0U);
+		case rtsha_page_size_type::PageTypeTLSF:
+			return (_storage_free_tlsf.available() > 0U);
+		case rtsha_page_size_type::PageTypePowerTwoBitmap:
+			return (_storage_free_buddy.available() > 0U);
+		case rtsha_page_size_type::PageTypeFixedBitmap:
+			return (_storage_free_slots.available() > 0U);
+		case rtsha_page_size_type::PageTypeArena:
+			return true;
+		default:
+			return (_storage_free_lists.available() > 0U);
+		}
+	}
 }
 
 namespace rtsha
@@ -179,9 +405,18 @@ namespace rtsha
 
 	Heap::~Heap() noexcept
 	{
+		if ((_provider != nullptr) && (_provider->ptrReleaseFunction != nullptr))
+		{
+			_provider->ptrReleaseFunction(reinterpret_cast<void*>(_heap_start), _heap_limit - _heap_start, _provider->context);
+		}
 	}
 
 	bool Heap::init(void* start, size_t size) noexcept
+	{
+		return init(start, size, rtsha_init_mode::InitZeroHeap, nullptr);
+	}
+
+	bool Heap::init(void* start, size_t size, rtsha_init_mode mode, rtshZeroMemoryPtr zero_function) noexcept
 	{
 		address_t a_start = rtsha_align( reinterpret_cast<address_t>(start), RTSHA_ALIGMENT);
 		size_t a_size = rtsha_align(size, RTSHA_ALIGMENT);
@@ -197,48 +432,171 @@ namespace rtsha
 		_heap_current_position = _heap_start;
 		_heap_size = a_size;
 		_number_pages = 0U;
+		_size_classes.fill(0U);
+		_bitmap_classes.fill(0U);
+		_bitmap_max_block_size = 0U;
+		_init_mode = mode;
+		_zero_function = zero_function;
 		_heap_init = true;
 
-		void* mem = reinterpret_cast<void*>(_heap_current_position);
+		if (rtsha_init_mode::InitZeroHeap == mode)
+		{
+			zero_memory(_heap_current_position, a_size);
+		}
+
+		_last_heap_error = RTSHA_OK;
+		return true;
+	}
+
+	bool Heap::init(RegionProviderStruct* provider, size_t initial_size, size_t max_size) noexcept
+	{
+		if ((provider == nullptr) || (provider->ptrReserveFunction == nullptr) || (provider->ptrCommitFunction == nullptr) ||
+			(provider->granularity == 0U) || ((provider->granularity & (provider->granularity - 1U)) != 0U) ||
+			(initial_size == 0U) || (initial_size > max_size) || (_provider != nullptr))
+		{
+			_last_heap_error = RTSHA_ErrorInit;
+			return false;
+		}
+		const size_t reserved = rtsha_align(max_size, provider->granularity);
+		const size_t committed = rtsha_align(initial_size, provider->granularity);
+		void* start = provider->ptrReserveFunction(reserved, provider->context);
+		if (start == nullptr)
+		{
+			_last_heap_error = RTSHA_ErrorInit;
+			return false;
+		}
+		if (!provider->ptrCommitFunction(start, committed, provider->context))
+		{
+			if (provider->ptrReleaseFunction != nullptr)
+			{
+				provider->ptrReleaseFunction(start, reserved, provider->context);
+			}
+			_last_heap_error = RTSHA_ErrorInit;
+			return false;
+		}
 
-		memset( mem, 0U, a_size  );
+		/*the committed memory is filled with zeros by the provider*/
+		_init_mode = rtsha_init_mode::InitNoZero;
+		_heap_start = reinterpret_cast<address_t>(start);
+		_heap_top = _heap_start + committed;
+		_heap_limit = _heap_start + reserved;
+		_heap_current_position = _heap_start;
+		_heap_size = committed;
+		_number_pages = 0U;
+		_size_classes.fill(0U);
+		_bitmap_classes.fill(0U);
+		_bitmap_max_block_size = 0U;
+		_provider = provider;
+		_heap_init = true;
 
 		_last_heap_error = RTSHA_OK;
 		return true;
 	}
 
+	bool Heap::init_mapped(size_t initial_size, size_t max_size, uint32_t options) noexcept
+	{
+		if ((_provider != nullptr) || !rtsha_mmap_region_provider(&_mapped_provider, options))
+		{
+			_last_heap_error = RTSHA_ErrorInit;
+			return false;
+		}
+		return init(&_mapped_provider, initial_size, max_size);
+	}
+
+	void Heap::set_page_growth(size_t page_size) noexcept
+	{
+		_grow_page_size = page_size;
+	}
+
+	void Heap::set_stream_threshold(size_t size) noexcept
+	{
+		_stream_threshold = size;
+	}
+
 	bool Heap::add_page(HeapCallbacksStruct* callbacks, rtsha_page_size_type size_type, size_t size, size_t max_objects, size_t min_block_size, size_t max_block_size) noexcept
+	{
+		return (nullptr != create_page(callbacks, size_type, size, max_objects, min_block_size, max_block_size, false));
+	}
+
+	rtsha_page* Heap::add_pool_page(HeapCallbacksStruct* callbacks, size_t size, size_t block_size) noexcept
+	{
+		/*the page type values are odd numbers, an aligned block size can not be taken for one of them; the page type is 16 bits wide*/
+		if (((block_size % RTSHA_ALIGMENT) != 0U) || (block_size > UINT16_MAX))
+		{
+			_last_heap_error = RTSHA_ErrorInitPageSize;
+			return nullptr;
+		}
+		return create_page(callbacks, static_cast<rtsha_page_size_type>(block_size), size, 0U, 0U, 0U, true);
+	}
+
+	rtsha_page* Heap::create_page(HeapCallbacksStruct* callbacks, rtsha_page_size_type size_type, size_t size, size_t max_objects, size_t min_block_size, size_t max_block_size, bool dedicated, address_t position) noexcept
 	{
 		size_t a_size = rtsha_align(size, RTSHA_ALIGMENT);
-		if (_heap_top < (_heap_current_position + (a_size - sizeof(rtsha_page))))
+		if (a_size > RTSHA_MAX_PAGE_SIZE)
 		{
-			_last_heap_error = RTSHA_ErrorInitOutOfHeap;
-			return false;
+			/*block sizes and distances must fit into the block header*/
+			_last_heap_error = RTSHA_ErrorInitPageSize;
+			return nullptr;
+		}
+		if ((_number_pages >= MAX_PAGES) || !has_page_storage(size_type))
+		{
+			_last_heap_error = RTSHA_NoPages;
+			return nullptr;
+		}
+		const bool at_end = (position == 0U);
+		if (at_end)
+		{
+			/*the whole page, including its tail, must be committed*/
+			if (((_heap_current_position + a_size) > _heap_top) && !grow_heap(a_size))
+			{
+				_last_heap_error = RTSHA_ErrorInitOutOfHeap;
+				return nullptr;
+			}
+			position = _heap_current_position;
 		}
 				
-		rtsha_page* page = reinterpret_cast<rtsha_page*>(_heap_current_position);
+		/*all fields of the page header are written, the heap memory may not be set to zero*/
+		rtsha_page* page = new (reinterpret_cast<void*>(position)) rtsha_page();
 
 		page->callbacks = callbacks;
 
 		/*set this page as last page*/
 		page->flags = static_cast<uint32_t>( size_type );
 
-		page->end_position = _heap_current_position + a_size;
+		page->dedicated = dedicated;
+
+		page->end_position = position + a_size;
 
 		page->free_blocks = 0U;
 		
 		page->last_block = nullptr;
 
 		/*set page blocks current possition*/
-		page->position = _heap_current_position + sizeof(rtsha_page);
+		page->position = position + sizeof(rtsha_page);
 
 		page->start_position = page->position;
 
+		if (rtsha_init_mode::InitZeroPages == _init_mode)
+		{
+			/*the blocks of fixed size pages are set to zero when they are taken from the untouched area*/
+			if ((static_cast<size_t>(size_type) % RTSHA_ALIGMENT) == 0U)
+			{
+				page->zero_blocks = true;
+			}
+			else
+			{
+				zero_memory(page->start_position, page->end_position - page->start_position);
+			}
+		}
+
+		bool size_class = false;
+		bool bitmap_class = false;
+
 		if (rtsha_page_size_type::PageTypeBig == size_type)
 		{
 			if (page->end_position <= (page->position + 64U))
 			{
-				return false;
+				return nullptr;
 			}
 			_big_page_used = true;
 			init_big_block_page(page, a_size, max_objects);
@@ -247,26 +605,89 @@ namespace rtsha
 		{
 			if (min_block_size == 0U || max_block_size == 0U)
 			{
-				return false;
+				return nullptr;
 			}
 			init_power_two_page(page, a_size, max_objects, min_block_size, max_block_size);
 		}
+		else if (rtsha_page_size_type::PageTypeTLSF == size_type)
+		{
+			if ((page->end_position <= (page->position + TLSF_LAST_BLOCK_SIZE + TLSF_MIN_BLOCK_SIZE)) ||
+				((page->end_position - page->position) >= TLSF_MAX_BLOCK_SIZE))
+			{
+				return nullptr;
+			}
+			_tlsf_page_used = true;
+			init_tlsf_page(page);
+		}
+		else if (rtsha_page_size_type::PageTypePowerTwoBitmap == size_type)
+		{
+			if ((min_block_size == 0U) || (max_block_size == 0U) || !init_power_two_bitmap_page(page, min_block_size, max_block_size))
+			{
+				return nullptr;
+			}
+			_bitmap_page_used = true;
+			bitmap_class = true;
+		}
+		else if (rtsha_page_size_type::PageTypeFixedBitmap == size_type)
+		{
+			/*the block size is given by 'max_block_size'*/
+			if ((max_block_size == 0U) || !init_fixed_bitmap_page(page, max_block_size))
+			{
+				return nullptr;
+			}
+			_bitmap_page_used = true;
+			bitmap_class = true;
+		}
+		else if (rtsha_page_size_type::PageTypeArena == size_type)
+		{
+			if (page->end_position <= page->position)
+			{
+				return nullptr;
+			}
+			init_arena_page(page);
+			_arena_page_used = true;
+		}
 		else
 		{
-			init_small_fix_page(page, a_size);
+			/*any aligned block size can be used for a fixed size page*/
+			const size_t block_size = static_cast<size_t>(size_type);
+			if ((block_size < static_cast<size_t>(rtsha_page_size_type::PageType16)) || ((block_size % RTSHA_ALIGMENT) != 0U) ||
+				((!dedicated) && (block_size > RTSHA_MAX_FIXED_BLOCK_SIZE)) || (a_size < (sizeof(rtsha_page) + block_size)))
+			{
+				_last_heap_error = RTSHA_ErrorInitPageSize;
+				return nullptr;
+			}
+			init_small_fix_page(page);
+			/*the blocks of a dedicated page are taken only by its owner*/
+			size_class = !dedicated;
+		}
+		if (at_end)
+		{
+			_heap_current_position += a_size;
 		}
+		page->next = reinterpret_cast<rtsha_page*>(page->end_position);
 		_pages[_number_pages] = page;
+		if (size_class)
+		{
+			add_size_class(_number_pages);
+		}
+		if (bitmap_class)
+		{
+			add_bitmap_class(_number_pages);
+		}
 		_number_pages++;
-		return true;
+		return page;
 	}
 	
 	size_t Heap::get_free_space() const noexcept
 	{
-		if (_heap_current_position >= _heap_top)
+		/*a growable heap can still commit the rest of its reserved region*/
+		const address_t top = (_provider != nullptr) ? _heap_limit : _heap_top;
+		if (_heap_current_position >= top)
 		{
 			return 0U;
 		}
-		return (static_cast<size_t>(_heap_top - _heap_current_position));
+		return (static_cast<size_t>(top - _heap_current_position));
 	}
 
 	rtsha_page_size_type Heap::get_ideal_page(size_t size) const noexcept
@@ -312,7 +733,7 @@ namespace rtsha
 		{
 			for (const auto& page : _pages)
 			{
-				if ((page != nullptr) && (page->flags == static_cast<uint32_t>( ideal_page) ))
+				if ((page != nullptr) && (!page->dedicated) && (page->flags == static_cast<uint32_t>( ideal_page) ))
 				{
 					return page;
 				}
@@ -324,10 +745,12 @@ namespace rtsha
 			/*check if big*/
 			if (size > (size_t)rtsha_page_size_type::PageType512)
 			{
-				/*use big page*/
+				/*use big or TLSF page*/
 				for (const auto& page : _pages)
 				{
-					if ((page != nullptr) && (page->flags == static_cast<uint32_t>( rtsha_page_size_type::PageTypeBig)))
+					if ((page != nullptr) &&
+						((page->flags == static_cast<uint32_t>( rtsha_page_size_type::PageTypeBig)) ||
+						 (page->flags == static_cast<uint32_t>( rtsha_page_size_type::PageTypeTLSF))))
 					{
 						return page;
 					}
@@ -338,15 +761,19 @@ namespace rtsha
 		/*try to use first that fits*/
 		for (const auto& page : _pages)
 		{
-			if ( (page != nullptr) )
+			if ( (page != nullptr) && (!page->dedicated) )
 			{
 				if ( (page->flags != static_cast<uint32_t>( rtsha_page_size_type::PageTypePowerTwo)) &&
 					 (page->flags != static_cast<uint32_t>( rtsha_page_size_type::PageTypeBig)) &&
+					 (page->flags != static_cast<uint32_t>( rtsha_page_size_type::PageTypeTLSF)) &&
+					 (page->flags != static_cast<uint32_t>( rtsha_page_size_type::PageTypePowerTwoBitmap)) &&
+					 (page->flags != static_cast<uint32_t>( rtsha_page_size_type::PageTypeFixedBitmap)) &&
 					 (size <= static_cast<size_t>(page->flags)) )
 				{
 					return page;
 				}
-				else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo))
+				else if ((page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo)) ||
+						 (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF)))
 				{
 					return page;
 				}
@@ -390,13 +817,43 @@ namespace rtsha
 		void* ret = nullptr;
 		if (size > 0U)
 		{
+			if (size <= _bitmap_max_block_size)
+			{
+				/*the blocks of the page have no header, the size is used as it is*/
+				ret = malloc_bitmap_page(size);
+				if (ret != nullptr)
+				{
+					return ret;
+				}
+			}
+
 			size_t a_size(size);
 			/*we have header and data*/
 			a_size += sizeof(rtsha_block);
 			/*and size2 as control block*/
-			a_size += sizeof(size_t);
+			a_size += RTSHA_BLOCK_FOOTER_SIZE;
+
+			/*the fixed size page with the smallest block size which can hold the block*/
+			rtsha_page* fixed_page = select_fixed_page(a_size);
+			if (fixed_page != nullptr)
+			{
+				SmallFixMemoryPage memory_page(fixed_page);
+				ret = memory_page.allocate_block(static_cast<size_t>(fixed_page->flags));
+				if (ret != nullptr)
+				{
+					return ret;
+				}
+				if ((_grow_page_size > 0U) || (fixed_page->map_page != nullptr))
+				{
+					ret = malloc_grown_class(fixed_page);
+					if (ret != nullptr)
+					{
+						return ret;
+					}
+				}
+			}
 
-			if (_big_page_used && (get_big_memorypage() != nullptr) )
+			if ((_big_page_used && (get_big_memorypage() != nullptr)) || _tlsf_page_used)
 			{
 				rtsha_page_size_type ideal_page = get_ideal_page(a_size);
 				if (ideal_page != rtsha_page_size_type::PageTypeNotDefined)
@@ -408,18 +865,28 @@ namespace rtsha
 						return ret;
 					}										
 
-					if (page->flags != static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
+					if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
 					{
-						a_size = page->flags;
-						SmallFixMemoryPage memory_page(page);
+						a_size = rtsha_align(a_size, RTSHA_ALIGMENT);
+						BigMemoryPage memory_page(page);
 						ret = memory_page.allocate_block(a_size);
 					}
-					else
+					else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF))
 					{
 						a_size = rtsha_align(a_size, RTSHA_ALIGMENT);
-						BigMemoryPage memory_page(page);
+						TLSFMemoryPage memory_page(page);
+						ret = memory_page.allocate_block(a_size);
+					}
+					else
+					{
+						a_size = page->flags;
+						SmallFixMemoryPage memory_page(page);
 						ret = memory_page.allocate_block(a_size);
 					}
+					if ((ret == nullptr) && (_grow_page_size > 0U) && (a_size > static_cast<size_t>(rtsha_page_size_type::PageType512)))
+					{
+						ret = malloc_grown_variable(a_size, page);
+					}
 				}
 			}
 			else
@@ -437,7 +904,8 @@ namespace rtsha
 					PowerTwoMemoryPage memory_page(page);
 					if( a_size < page->min_block_size)
 					{
-						page->callbacks->ptrErrorFunction(RTSHA_BlockSizeNotAllowed);
+						/*smaller blocks can not hold the free list node*/
+						a_size = page->min_block_size;
 					}
 					ret = memory_page.allocate_block(a_size);
 				}
@@ -452,40 +920,642 @@ namespace rtsha
 		return ret;
 	}
 
-	void Heap::free(void* ptr) noexcept
+	void* Heap::malloc_bitmap_page(size_t size) noexcept
 	{
-		if (ptr != nullptr)
+		if (size <= RTSHA_MAX_FIXED_BLOCK_SIZE)
 		{
-			size_t address = (size_t)ptr;
-			address -= sizeof(rtsha_block); /*skip size and pointer to prev*/
-			MemoryBlock block( reinterpret_cast<rtsha_block*>(address) );
-			
-			if (block.isValid())
+			const uint8_t index = _bitmap_classes[(size - 1U) / RTSHA_ALIGMENT];
+			if ((index != 0U) && (_pages[index - 1U]->free_blocks > 0U))
 			{
-				rtsha_page* page = get_block_page(static_cast<address_t>(address));
-				
-				if ( (page != nullptr) && (!block.isFree()) )
+				void* ret = allocate_bitmap_block(_pages[index - 1U], size);
+				if (ret != nullptr)
 				{
-					if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
-					{
-						BigMemoryPage memory_page(page);
-						memory_page.free_block(block);
-					}
-					else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo))
-					{
-						PowerTwoMemoryPage memory_page(page);
-						memory_page.free_block(block);
-					}
-					else
+					return ret;
+				}
+			}
+		}
+
+		/*best fit: the page with the smallest maximal block size which can hold the request and has a free block*/
+		rtsha_page* best = nullptr;
+		for (const auto& page : _pages)
+		{
+			if ((page != nullptr) && (size <= page->max_block_size) && (page->free_blocks > 0U) &&
+				((page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap)) ||
+				 (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))))
+			{
+				if ((best == nullptr) || (page->max_block_size < best->max_block_size))
+				{
+					best = page;
+				}
+			}
+		}
+
+		if (best == nullptr)
+		{
+			return nullptr;
+		}
+		return allocate_bitmap_block(best, size);
+	}
+
+	void* Heap::allocate_bitmap_block(rtsha_page* page, size_t size) noexcept
+	{
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))
+		{
+			FixedBitmapMemoryPage memory_page(page);
+			return memory_page.allocate_block(size);
+		}
+		PowerTwoBitmapMemoryPage memory_page(page);
+		return memory_page.allocate_block(size);
+	}
+
+	void* Heap::malloc_grown_class(rtsha_page* page) noexcept
+	{
+		/*the previous pages of the class may have free blocks again*/
+		for (rtsha_page* previous = page->map_page; previous != nullptr; previous = previous->map_page)
+		{
+			if (previous->free_blocks > 0U)
+			{
+				SmallFixMemoryPage memory_page(previous);
+				void* ret = memory_page.allocate_block(static_cast<size_t>(previous->flags));
+				if (ret != nullptr)
+				{
+					return ret;
+				}
+			}
+		}
+
+		/*a rebalanced class uses its previous pages also when the heap does not grow*/
+		const size_t page_index = get_class_page_index(page);
+		if ((_grow_page_size == 0U) || (page_index == _number_pages))
+		{
+			return nullptr;
+		}
+		rtsha_page* grown = create_page(page->callbacks, static_cast<rtsha_page_size_type>(page->flags), _grow_page_size, 0U, 0U, 0U, false);
+		if (grown == nullptr)
+		{
+			return nullptr;
+		}
+		take_over_class(grown, page, page_index);
+		SmallFixMemoryPage memory_page(grown);
+		return memory_page.allocate_block(static_cast<size_t>(grown->flags));
+	}
+
+	void Heap::take_over_class(rtsha_page* page, rtsha_page* current, size_t current_index) noexcept
+	{
+		/*the page is the last one, its index is '_number_pages - 1'*/
+		page->map_page = current;
+		for (auto& index : _size_classes)
+		{
+			if (index == static_cast<uint8_t>(current_index + 1U))
+			{
+				index = static_cast<uint8_t>(_number_pages);
+			}
+		}
+	}
+
+	size_t Heap::get_class_page_index(const rtsha_page* page) const noexcept
+	{
+		for (size_t page_index = 0U; page_index < _number_pages; page_index++)
+		{
+			if (_pages[page_index] == page)
+			{
+				for (const auto& index : _size_classes)
+				{
+					if (index == static_cast<uint8_t>(page_index + 1U))
 					{
-						SmallFixMemoryPage memory_page(page);
-						memory_page.free_block(block);
+						return page_index;
 					}
 				}
+				break;
+			}
+		}
+		return _number_pages;
+	}
+
+	size_t Heap::get_class_blocks(rtsha_page* page) noexcept
+	{
+		size_t blocks = 0U;
+		for (rtsha_page* previous = page; previous != nullptr; previous = previous->map_page)
+		{
+			SmallFixMemoryPage memory_page(previous);
+			blocks += memory_page.available_blocks() - previous->reserved_blocks;
+		}
+		return blocks;
+	}
+
+	rtsha_page* Heap::rebalance_page(rtsha_page* page, size_t size) noexcept
+	{
+		const size_t page_index = get_class_page_index(page);
+		if (page_index == _number_pages)
+		{
+			_last_heap_error = RTSHA_NoPage;
+			return nullptr;
+		}
+		const rtsha_page_size_type size_type = static_cast<rtsha_page_size_type>(page->flags);
+		const size_t a_size = rtsha_align(size, RTSHA_ALIGMENT);
+		if ((a_size > RTSHA_MAX_PAGE_SIZE) || (a_size < (sizeof(rtsha_page) + static_cast<size_t>(page->flags))))
+		{
+			_last_heap_error = RTSHA_ErrorInitPageSize;
+			return nullptr;
+		}
+		if ((_number_pages >= MAX_PAGES) || !has_page_storage(size_type))
+		{
+			/*the page can not be created once the donor has released its memory*/
+			_last_heap_error = RTSHA_NoPages;
+			return nullptr;
+		}
+
+		/*the donor is the page of another class with the largest untouched area*/
+		rtsha_page* donor = nullptr;
+		for (size_t i = 0U; i < _number_pages; i++)
+		{
+			rtsha_page* candidate = _pages[i];
+			if (is_class_page(candidate) && (candidate->flags != page->flags) &&
+				((candidate->end_position - candidate->position) >= a_size) &&
+				((donor == nullptr) || ((candidate->end_position - candidate->position) > (donor->end_position - donor->position))))
+			{
+				donor = candidate;
+			}
+		}
+		if (donor == nullptr)
+		{
+			_last_heap_error = RTSHA_NoFreePage;
+			return nullptr;
+		}
+
+		SmallFixMemoryPage donor_page(donor);
+		const address_t position = donor_page.release_unused(a_size);
+		if (position == 0U)
+		{
+			_last_heap_error = RTSHA_NoFreePage;
+			return nullptr;
+		}
+		rtsha_page* added = create_page(page->callbacks, size_type, a_size, 0U, 0U, 0U, false, position);
+		if (added != nullptr)
+		{
+			take_over_class(added, page, page_index);
+		}
+		return added;
+	}
+
+	bool Heap::warm_up(const rtsha_warm_up_entry* plan, size_t entries) noexcept
+	{
+		bool ret = (plan != nullptr);
+		for (size_t i = 0U; ret && (i < entries); i++)
+		{
+			ret = warm_up_blocks(plan[i].size, plan[i].count);
+		}
+		return ret;
+	}
+
+	bool Heap::warm_up_blocks(size_t size, size_t count) noexcept
+	{
+		size_t a_size(size);
+		a_size += sizeof(rtsha_block);
+		a_size += RTSHA_BLOCK_FOOTER_SIZE;
+
+		rtsha_page* fixed_page = select_fixed_page(a_size);
+		if (fixed_page != nullptr)
+		{
+			SmallFixMemoryPage memory_page(fixed_page);
+			if (!memory_page.prepare_free_blocks(count))
+			{
+				_last_heap_error = RTSHA_OutOfMemory;
+				return false;
+			}
+			return true;
+		}
+
+		/*all blocks are allocated before the first one is released; they are linked through their data*/
+		const size_t data_size = (size < sizeof(void*)) ? sizeof(void*) : size;
+		void* chain = nullptr;
+		size_t allocated = 0U;
+		while (allocated < count)
+		{
+			void* ptr = malloc(data_size);
+			if (ptr == nullptr)
+			{
+				break;
+			}
+			::memset(ptr, 0, data_size);
+			*reinterpret_cast<void**>(ptr) = chain;
+			chain = ptr;
+			allocated++;
+		}
+		while (chain != nullptr)
+		{
+			void* next = *reinterpret_cast<void**>(chain);
+			rtsha_page* page = get_block_page(reinterpret_cast<address_t>(chain));
+			if ((page != nullptr) && (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo)))
+			{
+				/*the blocks stay split*/
+				MemoryBlock block(reinterpret_cast<rtsha_block*>(reinterpret_cast<address_t>(chain) - sizeof(rtsha_block)));
+				PowerTwoMemoryPage memory_page(page);
+				memory_page.free_split_block(block);
+			}
+			else
+			{
+				free(chain);
+			}
+			chain = next;
+		}
+		if (allocated < count)
+		{
+			_last_heap_error = RTSHA_OutOfMemory;
+			return false;
+		}
+		return true;
+	}
+
+	bool Heap::reserve(size_t size, size_t count, rtsha_reservation& token) noexcept
+	{
+		size_t a_size(size);
+		a_size += sizeof(rtsha_block);
+		a_size += RTSHA_BLOCK_FOOTER_SIZE;
+
+		rtsha_page* page = (token.page != nullptr) ? token.page : select_fixed_page(a_size);
+		if ((page == nullptr) || (a_size > static_cast<size_t>(page->flags)))
+		{
+			_last_heap_error = RTSHA_NoPage;
+			return false;
+		}
+		SmallFixMemoryPage memory_page(page);
+		if (!memory_page.reserve_blocks(count))
+		{
+			_last_heap_error = RTSHA_OutOfMemory;
+			return false;
+		}
+		token.page = page;
+		token.count += count;
+		return true;
+	}
+
+	void* Heap::malloc_reserved(rtsha_reservation& token) noexcept
+	{
+		if ((token.page == nullptr) || (token.count == 0U))
+		{
+			return nullptr;
+		}
+		SmallFixMemoryPage memory_page(token.page);
+		void* ret = memory_page.allocate_reserved_block();
+		if (ret != nullptr)
+		{
+			token.count--;
+			token.in_use++;
+		}
+		return ret;
+	}
+
+	void Heap::free_reserved(rtsha_reservation& token, void* ptr) noexcept
+	{
+		if ((token.page == nullptr) || (ptr == nullptr))
+		{
+			return;
+		}
+		const address_t address = reinterpret_cast<address_t>(ptr);
+		/*a block not allocated by 'malloc_reserved' must not extend the reservation*/
+		if ((token.in_use == 0U) || (address < (token.page->start_position + sizeof(rtsha_block))) || (address >= token.page->position))
+		{
+			_last_heap_error = RTSHA_InvalidBlock;
+			return;
+		}
+		MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block)));
+		if (!block.isValid() || block.isFree())
+		{
+			_last_heap_error = RTSHA_InvalidBlock;
+			return;
+		}
+		SmallFixMemoryPage memory_page(token.page);
+		memory_page.free_reserved_block(block);
+		token.count++;
+		token.in_use--;
+	}
+
+	void Heap::release_reservation(rtsha_reservation& token) noexcept
+	{
+		if (token.page != nullptr)
+		{
+			SmallFixMemoryPage memory_page(token.page);
+			memory_page.release_reserved_blocks(token.count);
+		}
+		token.page = nullptr;
+		token.count = 0U;
+		token.in_use = 0U;
+	}
+
+	size_t Heap::rebalance(size_t size, size_t min_blocks) noexcept
+	{
+		size_t created = 0U;
+		const size_t number_pages = _number_pages;
+		for (size_t i = 0U; i < number_pages; i++)
+		{
+			rtsha_page* page = _pages[i];
+			if (is_class_page(page) && (get_class_page_index(page) == i) && (get_class_blocks(page) < min_blocks))
+			{
+				if (rebalance_page(page, size) != nullptr)
+				{
+					created++;
+				}
+			}
+		}
+		return created;
+	}
+
+	void* Heap::malloc_grown_variable(size_t a_size, const rtsha_page* full) noexcept
+	{
+		for (const auto& page : _pages)
+		{
+			if ((page != nullptr) && (page != full) && (!page->dedicated) &&
+				(page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF)))
+			{
+				TLSFMemoryPage memory_page(page);
+				void* ret = memory_page.allocate_block(a_size);
+				if (ret != nullptr)
+				{
+					return ret;
+				}
+			}
+		}
+
+		/*the page must hold the block, the page header and the last block*/
+		size_t page_size = a_size + sizeof(rtsha_page) + TLSF_LAST_BLOCK_SIZE + TLSF_MIN_BLOCK_SIZE;
+		if (page_size < _grow_page_size)
+		{
+			page_size = _grow_page_size;
+		}
+		rtsha_page* grown = create_page(full->callbacks, rtsha_page_size_type::PageTypeTLSF, page_size, 0U, 0U, 0U, false);
+		if (grown == nullptr)
+		{
+			return nullptr;
+		}
+		TLSFMemoryPage memory_page(grown);
+		return memory_page.allocate_block(a_size);
+	}
+
+	size_t Heap::bitmap_usable_size(rtsha_page* page, address_t address) noexcept
+	{
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))
+		{
+			FixedBitmapMemoryPage memory_page(page);
+			return memory_page.usable_size(address);
+		}
+		PowerTwoBitmapMemoryPage memory_page(page);
+		return memory_page.usable_size(address);
+	}
+
+	void Heap::free(void* ptr) noexcept
+	{
+		if (ptr != nullptr)
+		{
+			/*the page is searched once, the page type selects the way the block is released*/
+			const address_t address = reinterpret_cast<address_t>(ptr);
+			rtsha_page* page = get_block_page(address);
+			if (page == nullptr)
+			{
+				return;
+			}
+			if (is_bitmap_page(page))
+			{
+				/*the block has no header*/
+				free_on_page(page, ptr);
+				return;
+			}
+			if (is_arena_page(page))
+			{
+				/*the blocks of an arena are released by arena_reset or arena_rewind*/
+				return;
+			}
+
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block))); /*skip size and pointer to prev*/
+			if (block.isValid() && !block.isFree())
+			{
+				free_on_page(page, ptr);
 			}
 		}
 	}
 
+	void Heap::free_sized(void* ptr, size_t size) noexcept
+	{
+		if (ptr != nullptr)
+		{
+			/*a block allocated on a fixed size page lies on the page of its size class*/
+			rtsha_page* page = select_fixed_page(size + sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE);
+			const address_t address = reinterpret_cast<address_t>(ptr);
+			if ((page != nullptr) && (address >= page->start_position) && (address < page->end_position))
+			{
+				page_free(page, ptr);
+				return;
+			}
+			this->free(ptr);
+		}
+	}
+
+	void* Heap::page_malloc(rtsha_page* page, size_t size) noexcept
+	{
+		if ((page == nullptr) || (size == 0U))
+		{
+			return nullptr;
+		}
+
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap))
+		{
+			PowerTwoBitmapMemoryPage memory_page(page);
+			return memory_page.allocate_block(size);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))
+		{
+			FixedBitmapMemoryPage memory_page(page);
+			return memory_page.allocate_block(size);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeArena))
+		{
+			ArenaMemoryPage memory_page(page);
+			return memory_page.allocate_block(size);
+		}
+
+		/*we have header, data and size2 as control block*/
+		size_t a_size = size + sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE;
+
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
+		{
+			BigMemoryPage memory_page(page);
+			return memory_page.allocate_block(rtsha_align(a_size, RTSHA_ALIGMENT));
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF))
+		{
+			TLSFMemoryPage memory_page(page);
+			return memory_page.allocate_block(rtsha_align(a_size, RTSHA_ALIGMENT));
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo))
+		{
+			a_size = ExpandToPowerOf2(a_size);
+			if (a_size < page->min_block_size)
+			{
+				/*smaller blocks can not hold the free list node*/
+				a_size = page->min_block_size;
+			}
+			PowerTwoMemoryPage memory_page(page);
+			return memory_page.allocate_block(a_size);
+		}
+
+		if (a_size > static_cast<size_t>(page->flags))
+		{
+			_last_heap_error = RTSHA_BlockSizeNotAllowed;
+			return nullptr;
+		}
+		SmallFixMemoryPage memory_page(page);
+		return memory_page.allocate_block(static_cast<size_t>(page->flags));
+	}
+
+	void Heap::page_free(rtsha_page* page, void* ptr) noexcept
+	{
+		if ((page == nullptr) || (ptr == nullptr))
+		{
+			return;
+		}
+		const address_t address = reinterpret_cast<address_t>(ptr);
+		if ((address < page->start_position) || (address >= page->end_position))
+		{
+			_last_heap_error = RTSHA_InvalidBlock;
+			return;
+		}
+		if ((page->flags != static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap)) &&
+			(page->flags != static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap)) &&
+			(page->flags != static_cast<uint32_t>(rtsha_page_size_type::PageTypeArena)))
+		{
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block)));
+			if (!block.isValid() || block.isFree())
+			{
+				_last_heap_error = RTSHA_InvalidBlock;
+				return;
+			}
+		}
+		free_on_page(page, ptr);
+	}
+
+	void Heap::free_on_page(rtsha_page* page, void* ptr) noexcept
+	{
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeFixedBitmap))
+		{
+			/*the block has no header*/
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(ptr));
+			FixedBitmapMemoryPage memory_page(page);
+			memory_page.free_block(block);
+			return;
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwoBitmap))
+		{
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(ptr));
+			PowerTwoBitmapMemoryPage memory_page(page);
+			memory_page.free_block(block);
+			return;
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeArena))
+		{
+			/*the blocks of an arena are released by arena_reset or arena_rewind*/
+			return;
+		}
+
+		MemoryBlock block(reinterpret_cast<rtsha_block*>(reinterpret_cast<address_t>(ptr) - sizeof(rtsha_block)));
+		if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
+		{
+			BigMemoryPage memory_page(page);
+			memory_page.free_block(block);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypePowerTwo))
+		{
+			PowerTwoMemoryPage memory_page(page);
+			memory_page.free_block(block);
+		}
+		else if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeTLSF))
+		{
+			TLSFMemoryPage memory_page(page);
+			memory_page.free_block(block);
+		}
+		else
+		{
+			SmallFixMemoryPage memory_page(page);
+			memory_page.free_block(block);
+		}
+	}
+
+	bool Heap::set_deferred_coalescing(rtsha_page* page, bool enable) noexcept
+	{
+		if ((page == nullptr) || (page->flags != static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig)))
+		{
+			_last_heap_error = RTSHA_NoPage;
+			return false;
+		}
+		BigMemoryPage memory_page(page);
+		memory_page.set_deferred(enable);
+		return true;
+	}
+
+	size_t Heap::coalesce(size_t budget) noexcept
+	{
+		size_t count = 0U;
+		for (const auto& page : _pages)
+		{
+			if (count >= budget)
+			{
+				break;
+			}
+			if ((page != nullptr) && (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig)))
+			{
+				BigMemoryPage memory_page(page);
+				count += memory_page.coalesce(budget - count);
+			}
+		}
+		return count;
+	}
+
+	rtsha_page* Heap::add_arena_page(HeapCallbacksStruct* callbacks, size_t size) noexcept
+	{
+		return create_page(callbacks, rtsha_page_size_type::PageTypeArena, size, 0U, 0U, 0U, true);
+	}
+
+	void* Heap::arena_malloc(rtsha_page* page, size_t size, size_t alignment) noexcept
+	{
+		if (!is_arena_page(page))
+		{
+			_last_heap_error = RTSHA_NoPage;
+			return nullptr;
+		}
+		ArenaMemoryPage memory_page(page);
+		return memory_page.allocate_aligned(size, alignment);
+	}
+
+	address_t Heap::arena_marker(rtsha_page* page) noexcept
+	{
+		if (!is_arena_page(page))
+		{
+			return 0U;
+		}
+		ArenaMemoryPage memory_page(page);
+		return memory_page.marker();
+	}
+
+	bool Heap::arena_rewind(rtsha_page* page, address_t marker) noexcept
+	{
+		if (!is_arena_page(page))
+		{
+			return false;
+		}
+		ArenaMemoryPage memory_page(page);
+		return memory_page.rewind(marker);
+	}
+
+	bool Heap::arena_reset(rtsha_page* page) noexcept
+	{
+		if (!is_arena_page(page))
+		{
+			return false;
+		}
+		ArenaMemoryPage memory_page(page);
+		memory_page.reset();
+		return true;
+	}
+
 	void* Heap::calloc(size_t nitems, size_t size) noexcept
 	{
 		return malloc(nitems * size);
@@ -510,6 +1580,36 @@ namespace rtsha
 			return nullptr;
 		}
 
+		/*the page is searched once and used for the release of the old block*/
+		rtsha_page* page = get_block_page(reinterpret_cast<address_t>(ptr));
+		if (is_bitmap_page(page))
+		{
+			/*the block has no header, the size is taken from the page bitmaps*/
+			size_t old_size = bitmap_usable_size(page, reinterpret_cast<address_t>(ptr));
+			if (old_size == 0U)
+			{
+				return nullptr;
+			}
+			if (size <= old_size)
+			{
+				return ptr;
+			}
+			new_memory = this->malloc(size);
+			if (nullptr != new_memory)
+			{
+				::memcpy(new_memory, ptr, old_size);
+				free_on_page(page, ptr);
+			}
+			return new_memory;
+		}
+
+		if (is_arena_page(page))
+		{
+			/*the size of an arena block is not known*/
+			_last_heap_error = RTSHA_InvalidBlock;
+			return nullptr;
+		}
+
 		size_t address = (size_t)ptr;
 		address -= sizeof(rtsha_block); /*skip size and pointer to prev*/
 
@@ -547,76 +1647,149 @@ namespace rtsha
 			}
 		}
 
-		this->free(ptr);
+		if ((page != nullptr) && block.isValid() && !block.isFree())
+		{
+			free_on_page(page, ptr);
+		}
 
 		return new_memory;
 	}
 	
 
+	size_t Heap::block_extent(rtsha_page* page, address_t address) noexcept
+	{
+		if (is_bitmap_page(page))
+		{
+			/*the block has no header*/
+			return bitmap_usable_size(page, address);
+		}
+		if (is_arena_page(page))
+		{
+			/*only the allocated area of an arena can be used*/
+			return (address < page->position) ? static_cast<size_t>(page->position - address) : 0U;
+		}
+		if ((address - page->start_position) < sizeof(rtsha_block))
+		{
+			return 0U;
+		}
+		MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block))); /*skip size and pointer to prev*/
+		if (!block.isValid() || block.isFree() || (block.getSize() < (sizeof(rtsha_block) + RTSHA_BLOCK_FOOTER_SIZE)))
+		{
+			return 0U;
+		}
+		return block.getSize() - sizeof(rtsha_block) - RTSHA_BLOCK_FOOTER_SIZE;
+	}
+
 	void* Heap::memcpy(void* _Dst, void const* _Src, size_t _Size) noexcept
 	{
 		if ((_Src != nullptr) && (_Dst != nullptr) && (_Size > 0U))
 		{
-			size_t dst = reinterpret_cast<size_t>(_Dst);
-			size_t src = reinterpret_cast<size_t>(_Dst);
-
-			rtsha_page* dstPage = get_block_page(static_cast<address_t>(dst));
-			rtsha_page* srcPage = get_block_page(static_cast<address_t>(dst));
+			const address_t dst = reinterpret_cast<address_t>(_Dst);
+			const address_t src = reinterpret_cast<address_t>(_Src);
 
-			if (dstPage != nullptr)
+			/*an address outside of the heap is not checked*/
+			rtsha_page* dstPage = get_block_page(dst);
+			if ((dstPage != nullptr) && (block_extent(dstPage, dst) < _Size))
 			{
-				/*check destination block*/
-				address_t dstAddress = static_cast<address_t>(dst - sizeof(rtsha_block)); /*skip size and pointer to prev*/
-				MemoryBlock dstBlock(reinterpret_cast<rtsha_block*>(dstAddress));
-				if (!dstBlock.isValid() || (dstBlock.getSize() < _Size) || dstBlock.isFree())
-				{
-					return nullptr;
-				}
+				return nullptr;
 			}
-
-			if (srcPage != nullptr)
+			rtsha_page* srcPage = get_block_page(src);
+			if ((srcPage != nullptr) && (block_extent(srcPage, src) < _Size))
 			{
-				/*check source block*/
-				address_t srcAddress = static_cast<address_t>(src - sizeof(rtsha_block)); /*skip size and pointer to prev*/
-				MemoryBlock srcBlock(reinterpret_cast<rtsha_block*>(srcAddress));
-				if (!srcBlock.isValid() || (srcBlock.getSize() < _Size) || srcBlock.isFree() )
-				{
-					return nullptr;
-				}
+				return nullptr;
 			}
-
-
-#ifdef __arm__
-			return arm_wide64_memcpy(_Dst, _Src, _Size);
-#else
-
-			return memcpy(_Dst, _Src, _Size);
-#endif
+			return copy_memory(_Dst, _Src, _Size);
 		}
 		return nullptr;
 	}
-		
 
 	void* Heap::memset(void* _Dst, int _Val, size_t _Size) noexcept
 	{
 		if ((_Dst != nullptr) && (_Size > 0U))
 		{
-			size_t dst = reinterpret_cast<size_t>(_Dst);
-			rtsha_page* dstPage = get_block_page(static_cast<address_t>(dst));
+			const address_t dst = reinterpret_cast<address_t>(_Dst);
+			rtsha_page* dstPage = get_block_page(dst);
+			if ((dstPage != nullptr) && (block_extent(dstPage, dst) < _Size))
+			{
+				return nullptr;
+			}
+			return fill_memory(_Dst, _Val, _Size);
+		}
+		return nullptr;
+	}
 
-			if (dstPage != nullptr)
+	bool Heap::get_block_ref(void* ptr, rtsha_block_ref& ref) noexcept
+	{
+		ref = rtsha_block_ref();
+		const address_t address = reinterpret_cast<address_t>(ptr);
+		rtsha_page* page = nullptr;
+		if ((address >= (_heap_start + sizeof(rtsha_block))) && (address < _heap_current_position))
+		{
+			/*a block of a fixed size page is found through the size class table of its block size,
+			the page range check rejects a header which does not belong to such block*/
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(address - sizeof(rtsha_block)));
+			rtsha_page* fixed_page = select_fixed_page(block.getSize());
+			if ((fixed_page != nullptr) && (address >= fixed_page->start_position) && (address < fixed_page->end_position))
 			{
-				/*check destination block*/
-				address_t dstAddress = static_cast<address_t>(dst - sizeof(rtsha_block)); /*skip size and pointer to prev*/
-				MemoryBlock dstBlock(reinterpret_cast<rtsha_block*>(dstAddress));
-				if (!dstBlock.isValid() || (dstBlock.getSize() < _Size) || dstBlock.isFree())
-				{
-					return nullptr;
-				}
+				page = fixed_page;
 			}
-			return ::memset(_Dst, _Val, _Size);
+		}
+		if (page == nullptr)
+		{
+			page = get_block_page(address);
+		}
+		const size_t size = (page != nullptr) ? block_extent(page, address) : 0U;
+		if (size == 0U)
+		{
+			_last_heap_error = RTSHA_InvalidBlock;
+			return false;
+		}
+		ref.data = address;
+		ref.size = size;
+		return true;
+	}
+
+	void* Heap::memcpy(const rtsha_block_ref& dst, size_t dst_offset, const rtsha_block_ref& src, size_t src_offset, size_t size) noexcept
+	{
+		if ((size > 0U) && fits_block_ref(dst, dst_offset, size) && fits_block_ref(src, src_offset, size))
+		{
+			return copy_memory(reinterpret_cast<void*>(dst.data + dst_offset), reinterpret_cast<const void*>(src.data + src_offset), size);
+		}
+		return nullptr;
+	}
 
+	void* Heap::memset(const rtsha_block_ref& dst, size_t dst_offset, int value, size_t size) noexcept
+	{
+		if ((size > 0U) && fits_block_ref(dst, dst_offset, size))
+		{
+			return fill_memory(reinterpret_cast<void*>(dst.data + dst_offset), value, size);
 		}
 		return nullptr;
 	}
+
+	bool Heap::walk(rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		rtsha_walk_cursor cursor;
+		return walk(cursor, SIZE_MAX, callback, context);
+	}
+
+	bool Heap::walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		size_t steps = 0U;
+		while (!cursor.finished && (steps < max_steps))
+		{
+			if ((cursor.page_index >= _number_pages) || (_pages[cursor.page_index] == nullptr))
+			{
+				cursor.finished = true;
+				break;
+			}
+			steps += walk_page(_pages[cursor.page_index], cursor, max_steps - steps, callback, context);
+			if ((0U == cursor.position) && !cursor.finished)
+			{
+				/*the page has been walked, continue with the next one*/
+				cursor.page_index++;
+			}
+		}
+		return cursor.finished;
+	}
 }
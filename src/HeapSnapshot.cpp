@@ -0,0 +1,260 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "Heap.h"
+#include "HeapSnapshot.h"
+#include "FreeMap.h"
+
+#if defined(_MSC_VER)
+#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace internal
+{
+	static_assert(sizeof(rtsha_snapshot_header) == 40U, "snapshot header must not contain padding");
+	static_assert(sizeof(rtsha_snapshot_page) == 64U, "snapshot page record must not contain padding");
+	static_assert(sizeof(rtsha_snapshot_block) == 8U, "snapshot block record must not contain padding");
+	static_assert(sizeof(rtsha_snapshot_page_summary) == 48U, "snapshot page summary must not contain padding");
+
+	/**
+	* @brief State of the snapshot writer shared with the heap walker callback.
+	*/
+	struct snapshot_context
+	{
+		rtshSnapshotWritePtr			writer		= nullptr;
+		void*							context		= nullptr;
+		address_t						start		= 0U;
+		bool							ok			= true;
+		bool							blocks		= true;
+		rtsha_snapshot_page_summary		summary		= {};
+	};
+
+	/**
+	* @brief Destination of the snapshot written into a caller provided buffer.
+	*/
+	struct snapshot_buffer
+	{
+		uint8_t*	buffer		= nullptr;
+		size_t		size		= 0U;
+		size_t		written		= 0U;
+	};
+
+	static bool snapshot_write_block(const rtsha_block_info& info, void* context)
+	{
+		snapshot_context* ctx = reinterpret_cast<snapshot_context*>(context);
+
+		ctx->summary.number_blocks++;
+		if (info.free)
+		{
+			ctx->summary.free_bytes += info.size;
+			if (info.size > ctx->summary.largest_free_block)
+			{
+				ctx->summary.largest_free_block = info.size;
+			}
+		}
+		else
+		{
+			ctx->summary.used_bytes += info.size;
+		}
+
+		if (ctx->blocks)
+		{
+			rtsha_snapshot_block record;
+			record.offset = static_cast<uint32_t>(info.block - ctx->start);
+			record.size = static_cast<uint32_t>(info.size);
+			if (info.free)
+			{
+				record.size |= RTSHA_SNAPSHOT_BLOCK_FREE;
+			}
+			if (info.last)
+			{
+				record.size |= RTSHA_SNAPSHOT_BLOCK_LAST;
+			}
+			ctx->ok = ctx->writer(&record, sizeof(record), ctx->context);
+		}
+		return ctx->ok;
+	}
+
+	static bool snapshot_write_buffer(const void* data, size_t size, void* context)
+	{
+		snapshot_buffer* dst = reinterpret_cast<snapshot_buffer*>(context);
+		if ((dst->size - dst->written) < size)
+		{
+			return false;
+		}
+		std::memcpy(dst->buffer + dst->written, data, size);
+		dst->written += size;
+		return true;
+	}
+
+#if defined(_MSC_VER) || defined(__unix__) || defined(__APPLE__)
+	static bool snapshot_write_fd(const void* data, size_t size, void* context)
+	{
+		int fd = *reinterpret_cast<int*>(context);
+		const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+		while (size > 0U)
+		{
+#if defined(_MSC_VER)
+			int ret = _write(fd, ptr, static_cast<unsigned int>(size));
+#else
+			ssize_t ret = ::write(fd, ptr, size);
+#endif
+			if (ret <= 0)
+			{
+				return false;
+			}
+			ptr += ret;
+			size -= static_cast<size_t>(ret);
+		}
+		return true;
+	}
+#endif
+}
+
+namespace rtsha
+{
+	bool Heap::snapshot(rtshSnapshotWritePtr writer, void* context) noexcept
+	{
+		if (writer == nullptr)
+		{
+			return false;
+		}
+
+		rtsha_snapshot_header header;
+		header.magic		= RTSHA_SNAPSHOT_MAGIC;
+		header.version		= RTSHA_SNAPSHOT_VERSION;
+		header.address_size	= static_cast<uint16_t>(sizeof(size_t));
+		header.number_pages	= static_cast<uint32_t>(_number_pages);
+		header.last_error	= _last_heap_error;
+		header.heap_start	= static_cast<uint64_t>(_heap_start);
+		header.heap_size	= static_cast<uint64_t>(_heap_size);
+		header.heap_free	= static_cast<uint64_t>(get_free_space());
+
+		if (!writer(&header, sizeof(header), context))
+		{
+			return false;
+		}
+
+		for (size_t index = 0U; index < _number_pages; index++)
+		{
+			rtsha_page* page = _pages[index];
+
+			rtsha_snapshot_page record;
+			record.page_type		= page->flags;
+			record.index			= static_cast<uint32_t>(index);
+			record.start_position	= static_cast<uint64_t>(page->start_position);
+			record.end_position		= static_cast<uint64_t>(page->end_position);
+			record.position			= static_cast<uint64_t>(page->position);
+			record.free_blocks		= static_cast<uint64_t>(page->free_blocks);
+			record.max_blocks		= static_cast<uint64_t>(page->max_blocks);
+			record.min_block_size	= static_cast<uint64_t>(page->min_block_size);
+			record.max_block_size	= static_cast<uint64_t>(page->max_block_size);
+
+			if (!writer(&record, sizeof(record), context))
+			{
+				return false;
+			}
+
+			snapshot_context ctx;
+			ctx.writer	= writer;
+			ctx.context	= context;
+			ctx.start	= page->start_position;
+			ctx.blocks	= ((page->end_position - page->start_position) < static_cast<address_t>(RTSHA_SNAPSHOT_END_OF_PAGE));
+
+			rtsha_walk_cursor cursor;
+			walk_page(page, cursor, SIZE_MAX, snapshot_write_block, &ctx);
+			if (!ctx.ok)
+			{
+				return false;
+			}
+
+			rtsha_snapshot_block end_of_page;
+			end_of_page.offset = RTSHA_SNAPSHOT_END_OF_PAGE;
+			end_of_page.size = 0U;
+			if (!writer(&end_of_page, sizeof(end_of_page), context))
+			{
+				return false;
+			}
+
+			ctx.summary.flags = 0U;
+			if (cursor.inconsistent)
+			{
+				ctx.summary.flags |= RTSHA_SNAPSHOT_PAGE_INCONSISTENT;
+			}
+			if (!ctx.blocks)
+			{
+				ctx.summary.flags |= RTSHA_SNAPSHOT_PAGE_NO_BLOCKS;
+			}
+			if (page->flags == static_cast<uint32_t>(rtsha_page_size_type::PageTypeBig))
+			{
+				FreeMap* ptrMap = reinterpret_cast<FreeMap*>(page->ptr_list_map);
+				ctx.summary.free_index_entries = static_cast<uint64_t>(ptrMap->size() + ptrMap->deferred_size());
+			}
+			else
+			{
+				ctx.summary.free_index_entries = static_cast<uint64_t>(page->free_blocks);
+			}
+
+			if (!writer(&ctx.summary, sizeof(ctx.summary), context))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	size_t Heap::snapshot(void* buffer, size_t size) noexcept
+	{
+		if (buffer == nullptr)
+		{
+			return 0U;
+		}
+		snapshot_buffer dst;
+		dst.buffer	= reinterpret_cast<uint8_t*>(buffer);
+		dst.size	= size;
+		if (!snapshot(snapshot_write_buffer, &dst))
+		{
+			_last_heap_error = RTSHA_SnapshotBufferTooSmall;
+			return 0U;
+		}
+		return dst.written;
+	}
+
+#if defined(_MSC_VER) || defined(__unix__) || defined(__APPLE__)
+	bool Heap::snapshot_to_fd(int fd) noexcept
+	{
+		if (fd < 0)
+		{
+			return false;
+		}
+		return snapshot(snapshot_write_fd, &fd);
+	}
+#endif
+}
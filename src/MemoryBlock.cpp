@@ -49,8 +49,8 @@ namespace rtsha
 
 		if (!last)
 		{
-			rtsha_block* pOldNextRight = reinterpret_cast<rtsha_block*>((void*)((size_t)_block + osize));
-			pOldNextRight->prev = pNewNextRight;
+			MemoryBlock oldNextRight(reinterpret_cast<rtsha_block*>((void*)((size_t)_block + osize)));
+			oldNextRight.setPrevBlock(pNewNextRight);
 		}
 		else
 		{
@@ -83,8 +83,8 @@ namespace rtsha
 
 		if (!last)
 		{
-			rtsha_block* pOldNextRight = reinterpret_cast<rtsha_block*>((void*)((size_t)pNewNextRight + nsize));
-			pOldNextRight->prev = pNewNextRight;
+			MemoryBlock oldNextRight(reinterpret_cast<rtsha_block*>((void*)((size_t)pNewNextRight + nsize)));
+			oldNextRight.setPrevBlock(pNewNextRight);
 		}
 		else
 		{
@@ -125,8 +125,7 @@ namespace rtsha
 					prev.setLast();
 				}
 				/*destroy old header*/
-				this->_block->prev = 0U;
-				this->_block->size = 0U;
+				this->prepare();
 				this->_block = prev.getBlock();
 			}
 		}
@@ -141,8 +140,7 @@ namespace rtsha
 			if (!isLast && !next.isLast())
 			{
 				MemoryBlock nextNext(next.getNextBlock());
-				rtsha_block* next_next = next.getNextBlock();
-				if ( (next_next != nullptr) && (next_next->prev != nullptr) && ((size_t) next_next->prev == (size_t)next.getBlock()) )
+				if ( nextNext.hasPrev() && (nextNext.getPrev() == next.getBlock()) )
 				{
 					if (nextNext.isValid())					
 					{
@@ -37,6 +37,11 @@ namespace rtsha
 	{
 		if (this->fitOnPage(size))
 		{
+			if (_page->zero_blocks)
+			{
+				/*the heap has been initialized without setting the memory to zero*/
+				::memset(reinterpret_cast<void*>(this->getPosition()), 0, size);
+			}
 			MemoryBlock block(reinterpret_cast<rtsha_block*>((void*)this->getPosition()));
 			block.prepare(); /*memory can contain old bits*/
 			block.setSize(size);	
@@ -65,4 +70,60 @@ namespace rtsha
 		MemoryBlock block((rtsha_block*)(void*)address2);
 		return block.isValid();
 	}
+
+	size_t MemoryPage::walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		size_t steps = 0U;
+		address_t address = cursor.position;
+		if (0U == address)
+		{
+			address = this->getStartPosition();
+		}
+
+		while (steps < max_steps)
+		{
+			rtsha_block_info info;
+
+			this->lock();
+			address_t end = this->getPosition();
+			if (address >= end)
+			{
+				/*the whole page has been walked*/
+				this->unlock();
+				address = 0U;
+				break;
+			}
+
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(address));
+			size_t size = block.getSize();
+			if (!block.isValid() || (size < sizeof(rtsha_block)) || ((address + size) > end))
+			{
+				/*the block has been merged or the page has been changed since the last step*/
+				this->unlock();
+				cursor.inconsistent = true;
+				address = 0U;
+				break;
+			}
+			info.block		= address;
+			info.data		= reinterpret_cast<address_t>(block.getAllocAddress());
+			info.size		= size;
+			info.free		= block.isFree();
+			info.last		= block.isLast();
+			info.page_type	= this->getPageType();
+			info.page		= _page;
+			this->unlock();
+
+			address += size;
+			steps++;
+			cursor.visited++;
+
+			if ((callback != nullptr) && (false == callback(info, context)))
+			{
+				cursor.finished = true;
+				break;
+			}
+		}
+		cursor.position = address;
+		return steps;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,216 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+#include "MmapRegionProvider.h"
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#define RTSHA_MMAP_SUPPORTED
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdio.h>
+#endif
+
+namespace rtsha
+{
+#ifdef RTSHA_MMAP_SUPPORTED
+
+	static uint32_t mmap_options(void* context)
+	{
+		return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(context));
+	}
+
+	static size_t read_huge_page_size()
+	{
+#ifdef __linux__
+		size_t size = 0U;
+		FILE* file = fopen("/proc/meminfo", "r");
+		if (file != nullptr)
+		{
+			char line[128];
+			while (fgets(line, sizeof(line), file) != nullptr)
+			{
+				unsigned long kb = 0UL;
+				if (1 == sscanf(line, "Hugepagesize: %lu kB", &kb))
+				{
+					size = static_cast<size_t>(kb) * 1024U;
+					break;
+				}
+			}
+			(void)fclose(file);
+		}
+		/*transparent huge pages of x86-64 are used when the kernel has no explicit huge pages*/
+		return (size != 0U) ? size : (2U * 1024U * 1024U);
+#else
+		return 0U;
+#endif
+	}
+
+	size_t rtsha_huge_page_size() noexcept
+	{
+		static const size_t size = read_huge_page_size();
+		return size;
+	}
+
+	static void* mmap_reserve(size_t size, void* context)
+	{
+		/*no access rights, the address space does not use physical memory before it is committed*/
+		const size_t alignment = (0U != (mmap_options(context) & RTSHA_MMAP_HUGE_PAGES)) ? rtsha_huge_page_size() : 0U;
+		void* ptr = mmap(nullptr, size + alignment, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+		if (ptr == MAP_FAILED)
+		{
+			return nullptr;
+		}
+		if (alignment > 0U)
+		{
+			/*the region starts at a huge page boundary, the rest of the mapping is returned*/
+			const uintptr_t start = reinterpret_cast<uintptr_t>(ptr);
+			const uintptr_t aligned = (start + alignment - 1U) & ~(static_cast<uintptr_t>(alignment) - 1U);
+			if (aligned > start)
+			{
+				(void)munmap(ptr, aligned - start);
+			}
+			if ((start + alignment) > aligned)
+			{
+				(void)munmap(reinterpret_cast<void*>(aligned + size), (start + alignment) - aligned);
+			}
+			ptr = reinterpret_cast<void*>(aligned);
+		}
+		return ptr;
+	}
+
+	static bool mmap_populate(void* address, size_t size)
+	{
+#ifdef MADV_POPULATE_WRITE
+		if (0 == madvise(address, size, MADV_POPULATE_WRITE))
+		{
+			return true;
+		}
+#endif
+		/*one write per page faults the memory in; anonymous memory is filled with zeros*/
+		const long page_size = sysconf(_SC_PAGESIZE);
+		const size_t step = (page_size > 0) ? static_cast<size_t>(page_size) : 4096U;
+		volatile uint8_t* ptr = reinterpret_cast<volatile uint8_t*>(address);
+		for (size_t offset = 0U; offset < size; offset += step)
+		{
+			ptr[offset] = 0U;
+		}
+		return true;
+	}
+
+	static bool mmap_commit(void* address, size_t size, void* context)
+	{
+		const uint32_t options = mmap_options(context);
+		bool committed = false;
+		bool populated = false;
+		if (0U != (options & RTSHA_MMAP_HUGE_PAGES))
+		{
+#ifdef MAP_HUGETLB
+			/*explicit huge pages replace the reserved range; this fails when the huge page pool of the system is empty*/
+			const int populate = (0U != (options & RTSHA_MMAP_POPULATE)) ? MAP_POPULATE : 0;
+			committed = (MAP_FAILED != mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED | MAP_HUGETLB | populate, -1, 0));
+			populated = committed;
+#endif
+			if (!committed)
+			{
+				/*a failed mapping may have removed the reserved range, it is mapped again*/
+				committed = (MAP_FAILED != mmap(address, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0));
+#ifdef MADV_HUGEPAGE
+				if (committed)
+				{
+					/*the advice is ignored when transparent huge pages are disabled*/
+					(void)madvise(address, size, MADV_HUGEPAGE);
+				}
+#endif
+			}
+		}
+		else
+		{
+			/*anonymous mappings are filled with zeros*/
+			committed = (0 == mprotect(address, size, PROT_READ | PROT_WRITE));
+		}
+		if (committed && (!populated) && (0U != (options & RTSHA_MMAP_POPULATE)))
+		{
+			committed = mmap_populate(address, size);
+		}
+		if (committed && (0U != (options & RTSHA_MMAP_LOCK)))
+		{
+			committed = (0 == mlock(address, size));
+		}
+		return committed;
+	}
+
+	static void mmap_release(void* address, size_t size, void* context)
+	{
+		(void)context;
+		/*the locked memory is unlocked by 'munmap'*/
+		(void)munmap(address, size);
+	}
+
+	bool rtsha_mmap_region_provider(RegionProviderStruct* provider, uint32_t options) noexcept
+	{
+		if (provider == nullptr)
+		{
+			return false;
+		}
+		size_t granularity = 0U;
+		if (0U != (options & RTSHA_MMAP_HUGE_PAGES))
+		{
+			granularity = rtsha_huge_page_size();
+			if (granularity == 0U)
+			{
+				return false;
+			}
+		}
+		else
+		{
+			long page_size = sysconf(_SC_PAGESIZE);
+			granularity = (page_size > 0) ? static_cast<size_t>(page_size) : 4096U;
+		}
+		provider->ptrReserveFunction	= mmap_reserve;
+		provider->ptrCommitFunction		= mmap_commit;
+		provider->ptrReleaseFunction	= mmap_release;
+		provider->granularity			= granularity;
+		provider->context				= reinterpret_cast<void*>(static_cast<uintptr_t>(options));
+		return true;
+	}
+
+#else
+
+	bool rtsha_mmap_region_provider(RegionProviderStruct* provider, uint32_t options) noexcept
+	{
+		(void)provider;
+		(void)options;
+		return false;
+	}
+
+	size_t rtsha_huge_page_size() noexcept
+	{
+		return 0U;
+	}
+
+#endif
+}
@@ -0,0 +1,198 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "PowerTwoBitmapMemoryPage.h"
+#include "FreeBuddyBitmap.h"
+#include "internal.h"
+#include "errors.h"
+
+namespace rtsha
+{
+	using namespace internal;
+
+	void* PowerTwoBitmapMemoryPage::allocate_block(const size_t& size) noexcept
+	{
+		RTSHA_EXPECTS(_page);
+		if (0U == size)
+		{
+			return nullptr;
+		}
+
+		FreeBuddyBitmap* ptrIndex = reinterpret_cast<FreeBuddyBitmap*>(this->getFreeMap());
+
+		size_t order = ptrIndex->min_order();
+		if (size > (static_cast<size_t>(1U) << order))
+		{
+			order = rtsha_fls(size - 1U) + 1U;
+		}
+		if (order > ptrIndex->max_order())
+		{
+			this->reportError(RTSHA_BlockSizeNotAllowed);
+			return nullptr;
+		}
+
+		this->lock();
+
+		size_t found = order;
+		address_t address = ptrIndex->pop(found);
+		if (address != 0U)
+		{
+			this->decFreeBlocks();
+			/*split down to the requested order, the right halves are free*/
+			while (found > order)
+			{
+				ptrIndex->set_split(address, found, true);
+				found--;
+				ptrIndex->insert(address + (static_cast<size_t>(1U) << found), found);
+				this->incFreeBlocks();
+			}
+		}
+		this->unlock();
+		return reinterpret_cast<void*>(address);
+	}
+
+	void PowerTwoBitmapMemoryPage::free_block(MemoryBlock& block) noexcept
+	{
+		FreeBuddyBitmap* ptrIndex = reinterpret_cast<FreeBuddyBitmap*>(this->getFreeMap());
+		address_t address = reinterpret_cast<address_t>(block.getBlock());
+
+		this->lock();
+
+		size_t order = ptrIndex->order_of(address);
+		if ((0U == order) || ptrIndex->is_free(address, order))
+		{
+			/*not the start of a block or the block is already free*/
+			this->reportError(RTSHA_InvalidBlock);
+			this->unlock();
+			return;
+		}
+
+		/*merge with the buddy until the buddy is in use or has been split*/
+		while (order < ptrIndex->max_order())
+		{
+			address_t buddy = ptrIndex->base() + ((address - ptrIndex->base()) ^ (static_cast<size_t>(1U) << order));
+			if (!ptrIndex->is_free(buddy, order))
+			{
+				break;
+			}
+			ptrIndex->remove(buddy, order);
+			this->decFreeBlocks();
+			if (buddy < address)
+			{
+				address = buddy;
+			}
+			order++;
+			ptrIndex->set_split(address, order, false);
+		}
+		ptrIndex->insert(address, order);
+		this->incFreeBlocks();
+
+		this->unlock();
+	}
+
+	size_t PowerTwoBitmapMemoryPage::usable_size(address_t address) noexcept
+	{
+		FreeBuddyBitmap* ptrIndex = reinterpret_cast<FreeBuddyBitmap*>(this->getFreeMap());
+		size_t ret = 0U;
+		this->lock();
+		size_t order = ptrIndex->order_of(address);
+		if ((0U != order) && !ptrIndex->is_free(address, order))
+		{
+			ret = (static_cast<size_t>(1U) << order);
+		}
+		this->unlock();
+		return ret;
+	}
+
+	size_t PowerTwoBitmapMemoryPage::walk(rtsha_walk_cursor& cursor, size_t max_steps, rtshWalkBlockPtr callback, void* context) noexcept
+	{
+		FreeBuddyBitmap* ptrIndex = reinterpret_cast<FreeBuddyBitmap*>(this->getFreeMap());
+		size_t steps = 0U;
+		address_t address = cursor.position;
+		if (0U == address)
+		{
+			address = ptrIndex->base();
+		}
+
+		while (steps < max_steps)
+		{
+			rtsha_block_info info;
+
+			this->lock();
+			if (address >= ptrIndex->end())
+			{
+				/*the whole page has been walked*/
+				this->unlock();
+				address = 0U;
+				break;
+			}
+
+			size_t order = ptrIndex->order_of(address);
+			if (0U == order)
+			{
+				/*the block has been merged since the last step*/
+				this->unlock();
+				cursor.inconsistent = true;
+				address = 0U;
+				break;
+			}
+			size_t size = (static_cast<size_t>(1U) << order);
+			info.block		= address;
+			info.data		= address;
+			info.size		= size;
+			info.free		= ptrIndex->is_free(address, order);
+			info.last		= ((address + size) == ptrIndex->end());
+			info.page_type	= this->getPageType();
+			info.page		= _page;
+			this->unlock();
+
+			address += size;
+			steps++;
+			cursor.visited++;
+
+			if ((callback != nullptr) && (false == callback(info, context)))
+			{
+				cursor.finished = true;
+				break;
+			}
+		}
+		cursor.position = address;
+		return steps;
+	}
+
+	void PowerTwoBitmapMemoryPage::createInitialFreeBlocks() noexcept
+	{
+		FreeBuddyBitmap* ptrIndex = reinterpret_cast<FreeBuddyBitmap*>(this->getFreeMap());
+		const size_t top_size = (static_cast<size_t>(1U) << ptrIndex->max_order());
+		for (address_t address = ptrIndex->base(); address < ptrIndex->end(); address += top_size)
+		{
+			ptrIndex->insert(address, ptrIndex->max_order());
+			this->incFreeBlocks();
+		}
+	}
+}
@@ -117,56 +117,52 @@ namespace rtsha
 		/*set as free*/
 		block.setFree();
 
-		if (this->isLastPageBlock(block))
+		/*all blocks are aligned to their size relative to the first block of the page*/
+		const size_t base = this->getStartPosition();
+		const size_t end = this->getPosition();
+
+		/*merge with the buddy until the buddy is not free or has been split*/
+		while (block.isValid())
 		{
-			this->setFreeBlockAllocatorsAddress(block.getFreeBlockAddress());
-			ptrFreeListArray->push( reinterpret_cast<size_t>(block.getBlock()), block.getSize() );
-			this->incFreeBlocks();
-			this->unlock();
-			return;
-		}
-		/*merging loop left*/		
-		while (block.hasPrev() && (this->getFreeBlocks() > 0U))
-		{		
-			MemoryBlock prev(block.getPrev());					
-			if (prev.isValid() && prev.isFree() && (prev.getSize() == block.getSize()) )
+			size_t size = block.getSize();
+			size_t offset = reinterpret_cast<size_t>(block.getBlock()) - base;
+			size_t buddy_address = base + (offset ^ size);
+
+			if ((buddy_address + size) > end)
 			{
-				/*merge two blocks*/
-				if( ptrFreeListArray->delete_address(reinterpret_cast<size_t>(prev.getAllocAddress()), prev.getBlock(), prev.getSize()) )
-				{
-					/*decrease the number of free blocks*/
-					this->decFreeBlocks();
-				}
-				block.merge_left();
+				/*the block is the last block of its size at the end of the page*/
 				break;
 			}
-			else
+
+			MemoryBlock buddy(reinterpret_cast<rtsha_block*>(buddy_address));
+			if (!buddy.isValid() || !buddy.isFree() || (buddy.getSize() != size))
 			{
 				break;
-			}			
-		}
-				
-		/*merging loop right*/
-		while (!block.isLast() && !this->isLastPageBlock(block) && (this->getFreeBlocks() > 0U))
-		{		
-			MemoryBlock next(block.getNextBlock());
+			}
 
-			if (next.isValid() && next.isFree() && (next.getSize() == block.getSize()))
+			if (ptrFreeListArray->delete_address(reinterpret_cast<size_t>(buddy.getAllocAddress()), buddy.getBlock(), size))
 			{
-				/*merge two blocks*/	
-				if (ptrFreeListArray->delete_address(reinterpret_cast<size_t>(next.getAllocAddress()), next.getBlock(), next.getSize()))
-				{
-					/*decrease the number of free blocks*/
-					this->decFreeBlocks();
-				}
-				block.merge_right();
-				break;
+				/*decrease the number of free blocks*/
+				this->decFreeBlocks();
+			}
+
+			if (buddy_address < reinterpret_cast<size_t>(block.getBlock()))
+			{
+				/*the buddy is on the left side*/
+				MemoryBlock right(block.getBlock());
+				buddy.merge_right();
+				/*destroy old header*/
+				right.prepare();
+				block = buddy;
 			}
 			else
 			{
-				break;
+				block.merge_right();
+				/*destroy old header*/
+				buddy.prepare();
 			}
 		}
+
 		if (block.isValid())
 		{
 			this->setFreeBlockAllocatorsAddress(block.getFreeBlockAddress());
@@ -182,12 +178,24 @@ namespace rtsha
 		this->unlock();
 	}
 
+	void PowerTwoMemoryPage::free_split_block(MemoryBlock& block) noexcept
+	{
+		FreeListArray* ptrFreeListArray = reinterpret_cast<FreeListArray*>(this->getFreeListArray());
+
+		this->lock();
+		block.setFree();
+		this->setFreeBlockAllocatorsAddress(block.getFreeBlockAddress());
+		ptrFreeListArray->push(reinterpret_cast<size_t>(block.getBlock()), block.getSize());
+		this->incFreeBlocks();
+		this->unlock();
+	}
+
 	void PowerTwoMemoryPage::createInitialFreeBlocks() noexcept
 	{
 		/*create initial free blocks*/
 		size_t data_size = this->getEndPosition() - this->getStartPosition();
 		size_t last_lbit = sizeof(SIZE_MAX) * 8U - 1U;
-		size_t val = 1U << last_lbit;
+		size_t val = static_cast<size_t>(1U) << last_lbit;
 		size_t rest = data_size;
 		rtsha_block* prev = nullptr;
 		FreeListArray* ptrFreeListArray = reinterpret_cast<FreeListArray*>(this->getFreeListArray());
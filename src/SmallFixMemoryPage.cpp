@@ -45,7 +45,35 @@ namespace rtsha
 		}
 
 		this->lock();
+		/*the reserved blocks are taken only by 'allocate_reserved_block'*/
+		if ((_page->reserved_blocks == 0U) || (available_blocks() > _page->reserved_blocks))
+		{
+			ret = take_block(size);
+		}
+		this->unlock();
+		return ret;
+	}
+
+	void* SmallFixMemoryPage::allocate_reserved_block() noexcept
+	{
+		void* ret = nullptr;
+		RTSHA_EXPECTS(_page);
 
+		this->lock();
+		if (_page->reserved_blocks > 0U)
+		{
+			ret = take_block(static_cast<size_t>(_page->flags));
+			if (ret != nullptr)
+			{
+				_page->reserved_blocks--;
+			}
+		}
+		this->unlock();
+		return ret;
+	}
+
+	void* SmallFixMemoryPage::take_block(const size_t& size) noexcept
+	{
 		/*try to use next free block*/
 		FreeList* ptrList = reinterpret_cast<FreeList*>(this->getFreeList());
 		size_t address = ptrList->pop();
@@ -56,19 +84,28 @@ namespace rtsha
 			MemoryBlock block(reinterpret_cast<rtsha_block*>((void*)address));
 			block.setAllocated();
 			//this->decreaseFree(size);
-			ret = block.getAllocAddress();
-			this->unlock();
-			return ret;
+			return block.getAllocAddress();
 		}
-		ret = allocate_block_at_current_pos(size);
-		this->unlock();
-		return ret;
+		return allocate_block_at_current_pos(size);
 	}
 
 	void SmallFixMemoryPage::free_block(MemoryBlock& block) noexcept
 	{
 		this->lock();
+		put_block(block);
+		this->unlock();
+	}
+
+	void SmallFixMemoryPage::free_reserved_block(MemoryBlock& block) noexcept
+	{
+		this->lock();
+		put_block(block);
+		_page->reserved_blocks++;
+		this->unlock();
+	}
 
+	void SmallFixMemoryPage::put_block(MemoryBlock& block) noexcept
+	{
 		/*set as free*/
 		block.setFree();
 
@@ -90,7 +127,60 @@ namespace rtsha
 		this->setFreeBlockAllocatorsAddress(block.getFreeBlockAddress());
 		ptrList->push(reinterpret_cast<size_t>(reinterpret_cast<void*>(block.getBlock())));
 		this->incFreeBlocks();
+	}
+
+	bool SmallFixMemoryPage::reserve_blocks(size_t count) noexcept
+	{
+		bool ret = false;
+		this->lock();
+		if ((available_blocks() - _page->reserved_blocks) >= count)
+		{
+			_page->reserved_blocks += count;
+			ret = true;
+		}
+		this->unlock();
+		return ret;
+	}
+
+	void SmallFixMemoryPage::release_reserved_blocks(size_t count) noexcept
+	{
+		this->lock();
+		_page->reserved_blocks -= (count < _page->reserved_blocks) ? count : _page->reserved_blocks;
+		this->unlock();
+	}
 
+	bool SmallFixMemoryPage::prepare_free_blocks(size_t count) noexcept
+	{
+		const size_t block_size = static_cast<size_t>(_page->flags);
+		while (this->getFreeBlocks() < count)
+		{
+			this->lock();
+			void* ptr = allocate_block_at_current_pos(block_size);
+			this->unlock();
+			if (ptr == nullptr)
+			{
+				return false;
+			}
+			/*touch the data, the free list link is written into it by free_block*/
+			memset(ptr, 0, block_size - sizeof(rtsha_block) - RTSHA_BLOCK_FOOTER_SIZE);
+			MemoryBlock block(reinterpret_cast<rtsha_block*>(reinterpret_cast<address_t>(ptr) - sizeof(rtsha_block)));
+			free_block(block);
+		}
+		return true;
+	}
+
+	address_t SmallFixMemoryPage::release_unused(const size_t& size) noexcept
+	{
+		address_t ret = 0U;
+		this->lock();
+		/*the reserved blocks must stay available*/
+		if (((_page->end_position - _page->position) >= size) &&
+			((available_blocks() - _page->reserved_blocks) >= ((size + static_cast<size_t>(_page->flags) - 1U) / static_cast<size_t>(_page->flags))))
+		{
+			_page->end_position -= size;
+			ret = _page->end_position;
+		}
 		this->unlock();
+		return ret;
 	}
 }
@@ -0,0 +1,170 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "TLSFMemoryPage.h"
+#include "FreeTLSF.h"
+#include "internal.h"
+#include "errors.h"
+
+namespace rtsha
+{
+	using namespace internal;
+
+	void* TLSFMemoryPage::allocate_block(const size_t& size) noexcept
+	{
+		void* ret(nullptr);
+		RTSHA_EXPECTS(_page);
+		if (0U == size)
+		{
+			return nullptr;
+		}
+		size_t a_size = (size < TLSF_MIN_BLOCK_SIZE) ? TLSF_MIN_BLOCK_SIZE : size;
+
+		this->lock();
+
+		FreeTLSF* ptrIndex = reinterpret_cast<FreeTLSF*>(this->getFreeMap());
+		rtsha_block* address = ptrIndex->pop(a_size);
+		if (address != nullptr)
+		{
+			this->decFreeBlocks();
+
+			MemoryBlock block(address);
+			if (!block.isValid() || !block.isFree())
+			{
+				assert(false);
+				this->reportError(RTSHA_InvalidBlock);
+				this->unlock();
+				return ret;
+			}
+
+			if ((block.getSize() - a_size) >= TLSF_MIN_BLOCK_SIZE)
+			{
+				/*the free block is never the last page block, the internal last block follows it*/
+				block.splitt(a_size, false);
+				MemoryBlock next(block.getNextBlock());
+				ptrIndex->insert(next.getBlock());
+				this->incFreeBlocks();
+			}
+			/*set block as allocated*/
+			block.setAllocated();
+			ret = block.getAllocAddress();
+		}
+		this->unlock();
+		return ret;
+	}
+
+	void TLSFMemoryPage::free_block(MemoryBlock& block) noexcept
+	{
+		this->lock();
+
+		FreeTLSF* ptrIndex = reinterpret_cast<FreeTLSF*>(this->getFreeMap());
+
+		if (this->isLastPageBlock(block))
+		{
+			/*it should never happen - the last internal block can not be free*/
+			assert(false);
+			this->unlock();
+			return;
+		}
+
+		/*set as free*/
+		block.setFree();
+
+		/*merge with the right neighbour*/
+		MemoryBlock next(block.getNextBlock());
+		if (next.isValid() && next.isFree())
+		{
+			ptrIndex->remove(next.getBlock());
+			this->decFreeBlocks();
+			block.merge_right();
+			/*destroy old header*/
+			next.prepare();
+		}
+
+		/*merge with the left neighbour*/
+		if (block.hasPrev())
+		{
+			MemoryBlock prev(block.getPrev());
+			if (prev.isValid() && prev.isFree())
+			{
+				ptrIndex->remove(prev.getBlock());
+				this->decFreeBlocks();
+				block.merge_left();
+			}
+		}
+
+		if (block.isValid())
+		{
+			ptrIndex->insert(block.getBlock());
+			this->incFreeBlocks();
+		}
+		else
+		{
+			assert(false);
+			this->reportError(RTSHA_InvalidBlock);
+		}
+
+		if (ptrIndex->size() != this->getFreeBlocks())
+		{
+			assert(false);
+			this->reportError(RTSHA_InvalidNumberOfFreeBlocks);
+		}
+		this->unlock();
+	}
+
+	void TLSFMemoryPage::createInitialFreeBlocks() noexcept
+	{
+		FreeTLSF* ptrIndex = reinterpret_cast<FreeTLSF*>(this->getFreeMap());
+
+		/*create one big free block (size is page_size - size of the last block)*/
+		size_t* pFirstBlock = reinterpret_cast<size_t*>(this->getPosition());
+		*pFirstBlock = 0U;
+		MemoryBlock first(reinterpret_cast<rtsha_block*>(pFirstBlock));
+		size_t bigSize = this->getEndPosition() - this->getPosition() - TLSF_LAST_BLOCK_SIZE;
+		first.prepare();
+		first.setSize(bigSize);
+		first.setAsFirst();
+		first.setFree();
+
+		/*create the allocated last block, it ensures that the page has an appropriate end block*/
+		size_t* pLastBlock = reinterpret_cast<size_t*>(reinterpret_cast<address_t>(pFirstBlock) + bigSize);
+		*pLastBlock = 0U;
+		MemoryBlock block(reinterpret_cast<rtsha_block*>(pLastBlock));
+		block.prepare();
+		block.setSize(TLSF_LAST_BLOCK_SIZE);
+		block.setPrev(first);
+		block.setAllocated();
+		block.setLast();
+
+		ptrIndex->insert(first.getBlock());
+		this->incFreeBlocks();
+
+		this->setLastBlock(block);
+		this->setPosition(reinterpret_cast<address_t>(pLastBlock) + TLSF_LAST_BLOCK_SIZE);
+	}
+}
@@ -104,4 +104,22 @@ void* rtsha_memset(void* _Dst, int _Val, size_t _Size)
 		return _heap->memset(_Dst, _Val, _Size);
 	}
 	return nullptr;
-}
\ No newline at end of file
+}
+
+size_t rtsha_snapshot(void* buffer, size_t size)
+{
+	if (_heap != nullptr)
+	{
+		return _heap->snapshot(buffer, size);
+	}
+	return 0U;
+}
+
+size_t rtsha_coalesce(size_t budget)
+{
+	if (_heap != nullptr)
+	{
+		return _heap->coalesce(budget);
+	}
+	return 0U;
+}
@@ -36,14 +36,32 @@ void* arm_wide64_memcpy(void* dst, const void* src, size_t n)
 	const uint8_t* s = (const uint8_t*)src;
 
 	// For large copies, use 64-bit wide transfers to exploit the Cortex-M7's wide memory interface.
-	if (n >= 8U)
+	// LDRD/STRD fault on unaligned addresses, so both pointers must reach 8-byte alignment together.
+	if ((n >= 16U) && (0U == (((uintptr_t)d ^ (uintptr_t)s) & 7U)))
 	{
+		// Copy the head bytes up to the first aligned address.
+		while (0U != ((uintptr_t)d & 7U))
+		{
+			*d++ = *s++;
+			n--;
+		}
+
 		// Cast pointers to 64-bit for word-wise copying.
 		uint64_t* dw = (uint64_t*)d;
 		const uint64_t* sw = (const uint64_t*)s;
 
-		// Copy 8 bytes at a time.
-		while (n >= 8)
+		// Copy 32 bytes per iteration to keep the bus busy, then 8 bytes at a time.
+		while (n >= 32U)
+		{
+			dw[0] = sw[0];
+			dw[1] = sw[1];
+			dw[2] = sw[2];
+			dw[3] = sw[3];
+			dw += 4;
+			sw += 4;
+			n -= 32U;
+		}
+		while (n >= 8U)
 		{
 			*dw++ = *sw++;
 			n -= 8U;
@@ -51,7 +69,25 @@ void* arm_wide64_memcpy(void* dst, const void* src, size_t n)
 
 		// Update byte pointers after word-wise copying.
 		d = (uint8_t*)dw;
-		s = (uint8_t*)sw;
+		s = (const uint8_t*)sw;
+	}
+	else if ((n >= 8U) && (0U == (((uintptr_t)d ^ (uintptr_t)s) & 3U)))
+	{
+		// Only 4-byte alignment can be shared: use 32-bit transfers.
+		while (0U != ((uintptr_t)d & 3U))
+		{
+			*d++ = *s++;
+			n--;
+		}
+		uint32_t* dw = (uint32_t*)d;
+		const uint32_t* sw = (const uint32_t*)s;
+		while (n >= 4U)
+		{
+			*dw++ = *sw++;
+			n -= 4U;
+		}
+		d = (uint8_t*)dw;
+		s = (const uint8_t*)sw;
 	}
 
 	// Copy any remaining bytes.
@@ -61,4 +97,45 @@ void* arm_wide64_memcpy(void* dst, const void* src, size_t n)
 	}
 	return dst;
 }
+
+void* arm_wide64_memset(void* dst, int value, size_t n)
+{
+	uint8_t* d = (uint8_t*)dst;
+	const uint8_t v = (uint8_t)value;
+
+	if (n >= 16U)
+	{
+		// Fill the head bytes up to the first 8-byte aligned address.
+		while (0U != ((uintptr_t)d & 7U))
+		{
+			*d++ = v;
+			n--;
+		}
+
+		const uint64_t pattern = 0x0101010101010101ULL * v;
+		uint64_t* dw = (uint64_t*)d;
+		while (n >= 32U)
+		{
+			dw[0] = pattern;
+			dw[1] = pattern;
+			dw[2] = pattern;
+			dw[3] = pattern;
+			dw += 4;
+			n -= 32U;
+		}
+		while (n >= 8U)
+		{
+			*dw++ = pattern;
+			n -= 8U;
+		}
+		d = (uint8_t*)dw;
+	}
+
+	// Fill any remaining bytes.
+	while (n--)
+	{
+		*d++ = v;
+	}
+	return dst;
+}
 #endif
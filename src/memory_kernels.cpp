@@ -0,0 +1,732 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+#include "memory_kernels.h"
+#include <string.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RTSHA_X86_KERNELS
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+/*MSVC compiles the AVX2 intrinsics without a target option*/
+#define RTSHA_TARGET_AVX2
+#else
+#define RTSHA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RTSHA_NEON_KERNELS
+#include <arm_neon.h>
+#elif defined(__arm__) //ARM architecture
+#include "arm_spec_functions.h"
+#endif
+
+namespace internal
+{
+	/*copies less than 16 bytes with two overlapping transfers of the largest fitting width*/
+	static inline void copy_small(uint8_t* d, const uint8_t* s, size_t n) noexcept
+	{
+		if (n >= 8U)
+		{
+			uint64_t head;
+			uint64_t tail;
+			::memcpy(&head, s, 8U);
+			::memcpy(&tail, s + n - 8U, 8U);
+			::memcpy(d, &head, 8U);
+			::memcpy(d + n - 8U, &tail, 8U);
+		}
+		else if (n >= 4U)
+		{
+			uint32_t head;
+			uint32_t tail;
+			::memcpy(&head, s, 4U);
+			::memcpy(&tail, s + n - 4U, 4U);
+			::memcpy(d, &head, 4U);
+			::memcpy(d + n - 4U, &tail, 4U);
+		}
+		else
+		{
+			while (n-- > 0U)
+			{
+				*d++ = *s++;
+			}
+		}
+	}
+
+	static inline void fill_small(uint8_t* d, uint8_t value, size_t n) noexcept
+	{
+		if (n >= 8U)
+		{
+			const uint64_t pattern = 0x0101010101010101ULL * value;
+			::memcpy(d, &pattern, 8U);
+			::memcpy(d + n - 8U, &pattern, 8U);
+		}
+		else
+		{
+			while (n-- > 0U)
+			{
+				*d++ = value;
+			}
+		}
+	}
+
+#ifdef RTSHA_X86_KERNELS
+
+	static void* copy_sse2(void* dst, const void* src, size_t size) noexcept
+	{
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		if (size < 16U)
+		{
+			copy_small(d, s, size);
+			return dst;
+		}
+		uint8_t* const end = d + size;
+		const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + size - 16U));
+
+		/*prologue: the first vector is stored unaligned, the loop continues at the next aligned destination*/
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+			const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16U));
+			const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32U));
+			const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48U));
+			_mm_store_si128(reinterpret_cast<__m128i*>(d), v0);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 16U), v1);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 32U), v2);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 48U), v3);
+			d += 64U;
+			s += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+			d += 16U;
+			s += 16U;
+			n -= 16U;
+		}
+		/*epilogue: the last vector overlaps the stored data*/
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16U), tail);
+		return dst;
+	}
+
+	static void* fill_sse2(void* dst, int value, size_t size) noexcept
+	{
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		if (size < 16U)
+		{
+			fill_small(d, static_cast<uint8_t>(value), size);
+			return dst;
+		}
+		uint8_t* const end = d + size;
+		const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(d), v);
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(d), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 16U), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 32U), v);
+			_mm_store_si128(reinterpret_cast<__m128i*>(d + 48U), v);
+			d += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			_mm_store_si128(reinterpret_cast<__m128i*>(d), v);
+			d += 16U;
+			n -= 16U;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16U), v);
+		return dst;
+	}
+
+	RTSHA_TARGET_AVX2 static void* copy_avx2(void* dst, const void* src, size_t size) noexcept
+	{
+		if (size < 64U)
+		{
+			return copy_sse2(dst, src, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		uint8_t* const end = d + size;
+		const __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + size - 32U));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+		const size_t skip = 32U - (reinterpret_cast<uintptr_t>(d) & 31U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 128U)
+		{
+			const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+			const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32U));
+			const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64U));
+			const __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96U));
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d), v0);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 32U), v1);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 64U), v2);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 96U), v3);
+			d += 128U;
+			s += 128U;
+			n -= 128U;
+		}
+		while (n >= 32U)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+			d += 32U;
+			s += 32U;
+			n -= 32U;
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32U), tail);
+		/*avoid the transition penalty of the following SSE code*/
+		_mm256_zeroupper();
+		return dst;
+	}
+
+	RTSHA_TARGET_AVX2 static void* fill_avx2(void* dst, int value, size_t size) noexcept
+	{
+		if (size < 64U)
+		{
+			return fill_sse2(dst, value, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		uint8_t* const end = d + size;
+		const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(d), v);
+		const size_t skip = 32U - (reinterpret_cast<uintptr_t>(d) & 31U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 128U)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d), v);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 32U), v);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 64U), v);
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d + 96U), v);
+			d += 128U;
+			n -= 128U;
+		}
+		while (n >= 32U)
+		{
+			_mm256_store_si256(reinterpret_cast<__m256i*>(d), v);
+			d += 32U;
+			n -= 32U;
+		}
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32U), v);
+		_mm256_zeroupper();
+		return dst;
+	}
+
+	/*below this size the streaming kernels use the cached stores, a partial line is not worth a fence*/
+	static constexpr size_t STREAM_MIN_SIZE = 256U;
+
+	static void* copy_stream_sse2(void* dst, const void* src, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return copy_sse2(dst, src, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		uint8_t* const end = d + size;
+		const __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + size - 16U));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+			const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 16U));
+			const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 32U));
+			const __m128i v3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + 48U));
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d), v0);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 16U), v1);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 32U), v2);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 48U), v3);
+			d += 64U;
+			s += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d), _mm_loadu_si128(reinterpret_cast<const __m128i*>(s)));
+			d += 16U;
+			s += 16U;
+			n -= 16U;
+		}
+		/*the streaming stores are weakly ordered*/
+		_mm_sfence();
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16U), tail);
+		return dst;
+	}
+
+	static void* fill_stream_sse2(void* dst, int value, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return fill_sse2(dst, value, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		uint8_t* const end = d + size;
+		const __m128i v = _mm_set1_epi8(static_cast<char>(value));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(d), v);
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d), v);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 16U), v);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 32U), v);
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d + 48U), v);
+			d += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			_mm_stream_si128(reinterpret_cast<__m128i*>(d), v);
+			d += 16U;
+			n -= 16U;
+		}
+		_mm_sfence();
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(end - 16U), v);
+		return dst;
+	}
+
+	RTSHA_TARGET_AVX2 static void* copy_stream_avx2(void* dst, const void* src, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return copy_avx2(dst, src, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		uint8_t* const end = d + size;
+		const __m256i tail = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + size - 32U));
+
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+		const size_t skip = 32U - (reinterpret_cast<uintptr_t>(d) & 31U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 128U)
+		{
+			const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s));
+			const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 32U));
+			const __m256i v2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 64U));
+			const __m256i v3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + 96U));
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d), v0);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32U), v1);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64U), v2);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96U), v3);
+			d += 128U;
+			s += 128U;
+			n -= 128U;
+		}
+		while (n >= 32U)
+		{
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s)));
+			d += 32U;
+			s += 32U;
+			n -= 32U;
+		}
+		_mm_sfence();
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32U), tail);
+		_mm256_zeroupper();
+		return dst;
+	}
+
+	RTSHA_TARGET_AVX2 static void* fill_stream_avx2(void* dst, int value, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return fill_avx2(dst, value, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		uint8_t* const end = d + size;
+		const __m256i v = _mm256_set1_epi8(static_cast<char>(value));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(d), v);
+		const size_t skip = 32U - (reinterpret_cast<uintptr_t>(d) & 31U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 128U)
+		{
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d), v);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 32U), v);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 64U), v);
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d + 96U), v);
+			d += 128U;
+			n -= 128U;
+		}
+		while (n >= 32U)
+		{
+			_mm256_stream_si256(reinterpret_cast<__m256i*>(d), v);
+			d += 32U;
+			n -= 32U;
+		}
+		_mm_sfence();
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(end - 32U), v);
+		_mm256_zeroupper();
+		return dst;
+	}
+
+	static bool has_avx2() noexcept
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return false;
+		}
+		__cpuid(info, 1);
+		/*the operating system must save the AVX registers*/
+		if ((0 == (info[2] & (1 << 27))) || (6U != (_xgetbv(0) & 6U)))
+		{
+			return false;
+		}
+		__cpuidex(info, 7, 0);
+		return (0 != (info[1] & (1 << 5)));
+#else
+		__builtin_cpu_init();
+		return (0 != __builtin_cpu_supports("avx2"));
+#endif
+	}
+
+	typedef void* (*copy_kernel_t)(void* dst, const void* src, size_t size);
+	typedef void* (*fill_kernel_t)(void* dst, int value, size_t size);
+
+	struct memory_kernels
+	{
+		copy_kernel_t	copy;
+		fill_kernel_t	fill;
+		copy_kernel_t	stream_copy;
+		fill_kernel_t	stream_fill;
+		const char*		name;
+	};
+
+	/*the kernels are selected on the first call, a heap can be used by static constructors*/
+	static const memory_kernels& kernels() noexcept
+	{
+		static const memory_kernels selected = has_avx2() ? memory_kernels{ copy_avx2, fill_avx2, copy_stream_avx2, fill_stream_avx2, "AVX2" }
+														  : memory_kernels{ copy_sse2, fill_sse2, copy_stream_sse2, fill_stream_sse2, "SSE2" };
+		return selected;
+	}
+
+	void* rtsha_copy(void* dst, const void* src, size_t size) noexcept
+	{
+		return kernels().copy(dst, src, size);
+	}
+
+	void* rtsha_fill(void* dst, int value, size_t size) noexcept
+	{
+		return kernels().fill(dst, value, size);
+	}
+
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept
+	{
+		return kernels().stream_copy(dst, src, size);
+	}
+
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept
+	{
+		return kernels().stream_fill(dst, value, size);
+	}
+
+	const char* rtsha_kernel_name() noexcept
+	{
+		return kernels().name;
+	}
+
+#elif defined(RTSHA_NEON_KERNELS)
+
+	void* rtsha_copy(void* dst, const void* src, size_t size) noexcept
+	{
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		if (size < 16U)
+		{
+			copy_small(d, s, size);
+			return dst;
+		}
+		uint8_t* const end = d + size;
+		const uint8x16_t tail = vld1q_u8(s + size - 16U);
+
+		/*prologue: the first vector is stored unaligned, the loop continues at the next aligned destination*/
+		vst1q_u8(d, vld1q_u8(s));
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			const uint8x16_t v0 = vld1q_u8(s);
+			const uint8x16_t v1 = vld1q_u8(s + 16U);
+			const uint8x16_t v2 = vld1q_u8(s + 32U);
+			const uint8x16_t v3 = vld1q_u8(s + 48U);
+			vst1q_u8(d, v0);
+			vst1q_u8(d + 16U, v1);
+			vst1q_u8(d + 32U, v2);
+			vst1q_u8(d + 48U, v3);
+			d += 64U;
+			s += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			vst1q_u8(d, vld1q_u8(s));
+			d += 16U;
+			s += 16U;
+			n -= 16U;
+		}
+		/*epilogue: the last vector overlaps the stored data*/
+		vst1q_u8(end - 16U, tail);
+		return dst;
+	}
+
+	void* rtsha_fill(void* dst, int value, size_t size) noexcept
+	{
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		if (size < 16U)
+		{
+			fill_small(d, static_cast<uint8_t>(value), size);
+			return dst;
+		}
+		uint8_t* const end = d + size;
+		const uint8x16_t v = vdupq_n_u8(static_cast<uint8_t>(value));
+		vst1q_u8(d, v);
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			vst1q_u8(d, v);
+			vst1q_u8(d + 16U, v);
+			vst1q_u8(d + 32U, v);
+			vst1q_u8(d + 48U, v);
+			d += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			vst1q_u8(d, v);
+			d += 16U;
+			n -= 16U;
+		}
+		vst1q_u8(end - 16U, v);
+		return dst;
+	}
+
+#if defined(__aarch64__)
+
+	/*below this size the streaming kernels use the cached stores*/
+	static constexpr size_t STREAM_MIN_SIZE = 256U;
+
+	/*store pair with a non-temporal hint*/
+	static inline void store_pair_nt(uint8_t* d, uint8x16_t v0, uint8x16_t v1) noexcept
+	{
+		__asm__ volatile("stnp %q0, %q1, [%2]" : : "w"(v0), "w"(v1), "r"(d) : "memory");
+	}
+
+	/*returns the size of the block zeroed by 'DC ZVA', or 0 if the instruction is prohibited*/
+	static size_t zva_block_size() noexcept
+	{
+		uint64_t dczid;
+		__asm__ volatile("mrs %0, dczid_el0" : "=r"(dczid));
+		return (0U != (dczid & 16U)) ? 0U : (static_cast<size_t>(4U) << (dczid & 15U));
+	}
+
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return rtsha_copy(dst, src, size);
+		}
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		const uint8_t* s = static_cast<const uint8_t*>(src);
+		uint8_t* const end = d + size;
+		const uint8x16_t tail = vld1q_u8(s + size - 16U);
+
+		vst1q_u8(d, vld1q_u8(s));
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		s += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			const uint8x16_t v0 = vld1q_u8(s);
+			const uint8x16_t v1 = vld1q_u8(s + 16U);
+			const uint8x16_t v2 = vld1q_u8(s + 32U);
+			const uint8x16_t v3 = vld1q_u8(s + 48U);
+			store_pair_nt(d, v0, v1);
+			store_pair_nt(d + 32U, v2, v3);
+			d += 64U;
+			s += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			vst1q_u8(d, vld1q_u8(s));
+			d += 16U;
+			s += 16U;
+			n -= 16U;
+		}
+		vst1q_u8(end - 16U, tail);
+		return dst;
+	}
+
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept
+	{
+		if (size < STREAM_MIN_SIZE)
+		{
+			return rtsha_fill(dst, value, size);
+		}
+		static const size_t zva_size = zva_block_size();
+		uint8_t* d = static_cast<uint8_t*>(dst);
+		uint8_t* const end = d + size;
+		if ((0 == static_cast<uint8_t>(value)) && (zva_size != 0U) && (size >= (2U * zva_size)))
+		{
+			/*zero whole blocks without reading the lines, the unaligned edges are set with the cached stores*/
+			uint8_t* first = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(d) + zva_size - 1U) & ~(static_cast<uintptr_t>(zva_size) - 1U));
+			uint8_t* last = reinterpret_cast<uint8_t*>(reinterpret_cast<uintptr_t>(end) & ~(static_cast<uintptr_t>(zva_size) - 1U));
+			rtsha_fill(d, 0, static_cast<size_t>(first - d));
+			for (uint8_t* block = first; block < last; block += zva_size)
+			{
+				__asm__ volatile("dc zva, %0" : : "r"(block) : "memory");
+			}
+			rtsha_fill(last, 0, static_cast<size_t>(end - last));
+			return dst;
+		}
+		const uint8x16_t v = vdupq_n_u8(static_cast<uint8_t>(value));
+		vst1q_u8(d, v);
+		const size_t skip = 16U - (reinterpret_cast<uintptr_t>(d) & 15U);
+		d += skip;
+		size_t n = size - skip;
+		while (n >= 64U)
+		{
+			store_pair_nt(d, v, v);
+			store_pair_nt(d + 32U, v, v);
+			d += 64U;
+			n -= 64U;
+		}
+		while (n >= 16U)
+		{
+			vst1q_u8(d, v);
+			d += 16U;
+			n -= 16U;
+		}
+		vst1q_u8(end - 16U, v);
+		return dst;
+	}
+
+#else
+
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept
+	{
+		return rtsha_copy(dst, src, size);
+	}
+
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept
+	{
+		return rtsha_fill(dst, value, size);
+	}
+
+#endif
+
+	const char* rtsha_kernel_name() noexcept
+	{
+		return "NEON";
+	}
+
+#elif defined(__arm__)
+
+	void* rtsha_copy(void* dst, const void* src, size_t size) noexcept
+	{
+		return arm_wide64_memcpy(dst, src, size);
+	}
+
+	void* rtsha_fill(void* dst, int value, size_t size) noexcept
+	{
+		return arm_wide64_memset(dst, value, size);
+	}
+
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept
+	{
+		return arm_wide64_memcpy(dst, src, size);
+	}
+
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept
+	{
+		return arm_wide64_memset(dst, value, size);
+	}
+
+	const char* rtsha_kernel_name() noexcept
+	{
+		return "ARM 64-bit";
+	}
+
+#else
+
+	void* rtsha_copy(void* dst, const void* src, size_t size) noexcept
+	{
+		return ::memcpy(dst, src, size);
+	}
+
+	void* rtsha_fill(void* dst, int value, size_t size) noexcept
+	{
+		return ::memset(dst, value, size);
+	}
+
+	void* rtsha_copy_stream(void* dst, const void* src, size_t size) noexcept
+	{
+		return ::memcpy(dst, src, size);
+	}
+
+	void* rtsha_fill_stream(void* dst, int value, size_t size) noexcept
+	{
+		return ::memset(dst, value, size);
+	}
+
+	const char* rtsha_kernel_name() noexcept
+	{
+		return "libc";
+	}
+
+#endif
+}
@@ -0,0 +1,343 @@
+/******************************************************************************
+The MIT License(MIT)
+
+Real Time Safety Heap Allocator (RTSHA)
+https://github.com/borisRadonic/RTSHA
+
+Copyright(c) 2023 Boris Radonic
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files(the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+******************************************************************************/
+
+
+/*
+* RTSHA heap snapshot analyzer.
+*
+* Host-side tool which reads a snapshot written by 'Heap::snapshot' or 'rtsha_snapshot'
+* and prints the occupancy map of every page, the usage per page type and the fragmentation.
+*
+* Build (host):
+*	g++ -std=c++17 -I../../include rtsha_analyze.cpp -o rtsha_analyze
+*	cl /std:c++17 /I..\..\include rtsha_analyze.cpp
+*
+* Usage:
+*	rtsha_analyze <snapshot file>
+*/
+
+#include "HeapSnapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	const size_t MAP_WIDTH = 64U;
+
+	struct PageData
+	{
+		rtsha_snapshot_page					page = {};
+		std::vector<rtsha_snapshot_block>	blocks;
+		rtsha_snapshot_page_summary			summary = {};
+	};
+
+	struct ClassUsage
+	{
+		size_t		pages = 0U;
+		uint64_t	size = 0U;
+		uint64_t	used_blocks = 0U;
+		uint64_t	free_blocks = 0U;
+		uint64_t	used_bytes = 0U;
+		uint64_t	free_bytes = 0U;
+		uint64_t	untouched_bytes = 0U;
+	};
+
+	class Reader
+	{
+	public:
+		explicit Reader(const std::vector<uint8_t>& data) : _data(data)
+		{
+		}
+
+		template<typename T>
+		bool read(T& value)
+		{
+			if ((_data.size() - _pos) < sizeof(T))
+			{
+				return false;
+			}
+			std::memcpy(&value, _data.data() + _pos, sizeof(T));
+			_pos += sizeof(T);
+			return true;
+		}
+
+	private:
+		const std::vector<uint8_t>& _data;
+		size_t _pos = 0U;
+	};
+
+	std::string pageTypeName(uint32_t type)
+	{
+		switch (type)
+		{
+		case 613U:
+			return "Big";
+		case 713U:
+			return "PowerTwo";
+		case 813U:
+			return "TLSF";
+		case 913U:
+			return "PowerTwoBitmap";
+		case 1013U:
+			return "FixedBitmap";
+		case 1113U:
+			return "Arena";
+		default:
+			return "Fix" + std::to_string(type);
+		}
+	}
+
+	/*blocks of fixed size pages are interchangeable, they can not be fragmented*/
+	bool isVariableSize(uint32_t type)
+	{
+		return (type == 613U) || (type == 713U) || (type == 813U) || (type == 913U);
+	}
+
+	double fragmentation(uint64_t free_bytes, uint64_t largest_free_block)
+	{
+		if (free_bytes == 0U)
+		{
+			return 0.0;
+		}
+		return 100.0 * (1.0 - (static_cast<double>(largest_free_block) / static_cast<double>(free_bytes)));
+	}
+
+	/*builds one line of the page occupancy map: '#' used, '.' free, '+' used and free, ' ' untouched*/
+	std::string occupancyMap(const PageData& data)
+	{
+		const uint64_t start = data.page.start_position;
+		const uint64_t span = (data.page.end_position > start) ? (data.page.end_position - start) : 1U;
+		std::vector<uint64_t> used(MAP_WIDTH, 0U);
+		std::vector<uint64_t> free(MAP_WIDTH, 0U);
+
+		for (const auto& block : data.blocks)
+		{
+			uint64_t size = block.size & ~static_cast<uint64_t>(3U);
+			uint64_t first = block.offset;
+			uint64_t last = first + size;
+			for (uint64_t pos = first; pos < last;)
+			{
+				size_t cell = static_cast<size_t>((pos * MAP_WIDTH) / span);
+				if (cell >= MAP_WIDTH)
+				{
+					break;
+				}
+				uint64_t cell_end = ((cell + 1U) * span + MAP_WIDTH - 1U) / MAP_WIDTH;
+				uint64_t n = ((cell_end < last) ? cell_end : last) - pos;
+				if (n == 0U)
+				{
+					n = 1U;
+				}
+				if (block.size & RTSHA_SNAPSHOT_BLOCK_FREE)
+				{
+					free[cell] += n;
+				}
+				else
+				{
+					used[cell] += n;
+				}
+				pos += n;
+			}
+		}
+
+		std::string line(MAP_WIDTH, ' ');
+		for (size_t i = 0U; i < MAP_WIDTH; i++)
+		{
+			if ((used[i] > 0U) && (free[i] > 0U))
+			{
+				line[i] = '+';
+			}
+			else if (used[i] > 0U)
+			{
+				line[i] = '#';
+			}
+			else if (free[i] > 0U)
+			{
+				line[i] = '.';
+			}
+		}
+		return line;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::fprintf(stderr, "usage: %s <snapshot file>\n", argv[0]);
+		return 1;
+	}
+
+	std::ifstream file(argv[1], std::ios::binary);
+	if (!file)
+	{
+		std::fprintf(stderr, "can not open '%s'\n", argv[1]);
+		return 1;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	Reader reader(data);
+	rtsha_snapshot_header header;
+	if (!reader.read(header) || (header.magic != RTSHA_SNAPSHOT_MAGIC))
+	{
+		std::fprintf(stderr, "'%s' is not a RTSHA heap snapshot\n", argv[1]);
+		return 1;
+	}
+	if (header.version != RTSHA_SNAPSHOT_VERSION)
+	{
+		std::fprintf(stderr, "unsupported snapshot version %u\n", static_cast<unsigned>(header.version));
+		return 1;
+	}
+
+	std::vector<PageData> pages;
+	for (uint32_t i = 0U; i < header.number_pages; i++)
+	{
+		PageData page;
+		if (!reader.read(page.page))
+		{
+			std::fprintf(stderr, "truncated snapshot (page %u)\n", i);
+			return 1;
+		}
+		rtsha_snapshot_block block;
+		while (true)
+		{
+			if (!reader.read(block))
+			{
+				std::fprintf(stderr, "truncated snapshot (blocks of page %u)\n", i);
+				return 1;
+			}
+			if (block.offset == RTSHA_SNAPSHOT_END_OF_PAGE)
+			{
+				break;
+			}
+			page.blocks.push_back(block);
+		}
+		if (!reader.read(page.summary))
+		{
+			std::fprintf(stderr, "truncated snapshot (summary of page %u)\n", i);
+			return 1;
+		}
+		pages.push_back(page);
+	}
+
+	std::printf("RTSHA heap snapshot: %u-bit target, heap size %llu, unassigned %llu, last error %u, %u pages\n\n",
+		static_cast<unsigned>(header.address_size * 8U),
+		static_cast<unsigned long long>(header.heap_size),
+		static_cast<unsigned long long>(header.heap_free),
+		header.last_error, header.number_pages);
+
+	std::map<uint32_t, ClassUsage> classes;
+	uint64_t total_free = 0U;
+	uint64_t total_largest = 0U;
+
+	for (const auto& page : pages)
+	{
+		const rtsha_snapshot_page& p = page.page;
+		const rtsha_snapshot_page_summary& s = page.summary;
+		uint64_t page_size = p.end_position - p.start_position;
+		uint64_t untouched = (p.end_position > p.position) ? (p.end_position - p.position) : 0U;
+
+		std::string frag = "n/a";
+		if (isVariableSize(p.page_type))
+		{
+			char text[16];
+			std::snprintf(text, sizeof(text), "%.1f%%", fragmentation(s.free_bytes, s.largest_free_block));
+			frag = text;
+		}
+
+		std::printf("page %u %-10s size %10llu blocks %8llu used %10llu free %10llu (%llu blocks, largest %llu) untouched %10llu fragmentation %s%s\n",
+			p.index, pageTypeName(p.page_type).c_str(),
+			static_cast<unsigned long long>(page_size),
+			static_cast<unsigned long long>(s.number_blocks),
+			static_cast<unsigned long long>(s.used_bytes),
+			static_cast<unsigned long long>(s.free_bytes),
+			static_cast<unsigned long long>(s.free_index_entries),
+			static_cast<unsigned long long>(s.largest_free_block),
+			static_cast<unsigned long long>(untouched),
+			frag.c_str(),
+			(s.flags & RTSHA_SNAPSHOT_PAGE_INCONSISTENT) ? " (changed while the snapshot was taken)" : "");
+
+		if (0U == (s.flags & RTSHA_SNAPSHOT_PAGE_NO_BLOCKS))
+		{
+			std::printf("  [%s]\n", occupancyMap(page).c_str());
+		}
+
+		ClassUsage& usage = classes[p.page_type];
+		usage.pages++;
+		usage.size += page_size;
+		usage.used_bytes += s.used_bytes;
+		usage.free_bytes += s.free_bytes;
+		usage.untouched_bytes += untouched;
+		for (const auto& block : page.blocks)
+		{
+			if (block.size & RTSHA_SNAPSHOT_BLOCK_FREE)
+			{
+				usage.free_blocks++;
+			}
+			else
+			{
+				usage.used_blocks++;
+			}
+		}
+
+		if (isVariableSize(p.page_type))
+		{
+			total_free += s.free_bytes + untouched;
+			uint64_t largest = (s.largest_free_block > untouched) ? s.largest_free_block : untouched;
+			if (largest > total_largest)
+			{
+				total_largest = largest;
+			}
+		}
+	}
+
+	std::printf("\nusage per page type:\n");
+	for (const auto& entry : classes)
+	{
+		const ClassUsage& usage = entry.second;
+		double used = (usage.size > 0U) ? (100.0 * static_cast<double>(usage.used_bytes) / static_cast<double>(usage.size)) : 0.0;
+		std::printf("  %-10s pages %2zu size %10llu used blocks %8llu free blocks %8llu used %5.1f%% free %10llu untouched %10llu\n",
+			pageTypeName(entry.first).c_str(), usage.pages,
+			static_cast<unsigned long long>(usage.size),
+			static_cast<unsigned long long>(usage.used_blocks),
+			static_cast<unsigned long long>(usage.free_blocks),
+			used,
+			static_cast<unsigned long long>(usage.free_bytes),
+			static_cast<unsigned long long>(usage.untouched_bytes));
+	}
+
+	std::printf("\nvariable size pages: free %llu, largest free range %llu, fragmentation %.1f%%\n",
+		static_cast<unsigned long long>(total_free),
+		static_cast<unsigned long long>(total_largest),
+		fragmentation(total_free, total_largest));
+	return 0;
+}